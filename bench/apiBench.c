@@ -0,0 +1,317 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Cost of the public API under contention, on the Linux port (bench/loopbackBench.c has the setup):
+//  - send:    sendDMX(), sendAddress() and dmxBegin() / dmxCommit() from 1 - 4 producer threads while the
+//             default instance keeps sending (periodic and on change, where every write wakes the send task)
+//  - receive: readAddress(), readFixture(), readFixtureInto(), a fixture view and frame acquisition from
+//             1 - 4 reader threads while frames arrive from a second instance looped into the default one
+//  - kernel:  the frame operations behind them, single threaded: send snapshot, receive publish / acquire
+//             and the receive decoder (ops_per_s of decode_* is its throughput in frames per second)
+// One CSV row per case, ns_per_op is the time one thread spends per call, ops_per_s the total rate of all threads.
+// Compare two runs with e.g. `join -t, <(sort old.csv) <(sort new.csv)` on the first three columns.
+
+#include "dmx4esp.h"
+#include "dmxHost.h"
+#include "dmxFrame.h"
+#include "dmxRxBuffer.h"
+#include "dmxDecoder.h"
+#include "esp_timer.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_THREADS 4
+#define FIFO_LEN 128
+#define FIXTURE_FOOTPRINT 16
+
+typedef struct worker {
+    int index;
+    uint32_t operations;
+    uint32_t checksum; // keeps reads from being optimized away
+} worker;
+
+typedef void (*workerLoop)(worker *w);
+
+typedef struct runArgs {
+    worker worker;
+    workerLoop loop;
+    pthread_barrier_t *barrier;
+} runArgs;
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void report(const char *group, const char *name, int threads, uint64_t operations, double seconds){
+    printf("%s,%s,%d,%llu,%.1f,%.0f\n", group, name, threads, (unsigned long long) operations,
+           seconds * 1e9 * threads / operations, operations / seconds);
+}
+
+static void* runWorker(void *parameters){
+    runArgs *args = parameters;
+    pthread_barrier_wait(args->barrier);
+    args->loop(&args->worker);
+    return NULL;
+}
+
+//runs loop on threads threads at once, operations each
+static void runThreads(const char *group, const char *name, int threads, uint32_t operations, workerLoop loop){
+    pthread_t handles[MAX_THREADS];
+    runArgs args[MAX_THREADS];
+    pthread_barrier_t barrier;
+
+    pthread_barrier_init(&barrier, NULL, threads + 1);
+    for(int i = 0; i < threads; i++){
+        args[i] = (runArgs) {.worker = {.index = i, .operations = operations}, .loop = loop, .barrier = &barrier};
+        pthread_create(&handles[i], NULL, runWorker, &args[i]);
+    }
+    double start = nowSeconds();
+    pthread_barrier_wait(&barrier);
+    for(int i = 0; i < threads; i++){
+        pthread_join(handles[i], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+    pthread_barrier_destroy(&barrier);
+
+    report(group, name, threads, (uint64_t) operations * threads, elapsed);
+}
+
+/* send side, every producer writes its own 128 channels */
+
+static void sendAddressLoop(worker *w){
+    uint16_t first = 1 + w->index * 128;
+    for(uint32_t i = 0; i < w->operations; i++){
+        sendAddress(first + (i & 127), (uint8_t) i);
+    }
+}
+
+static void sendDMXLoop(worker *w){
+    uint8_t data[512];
+    memset(data, w->index, sizeof(data));
+    for(uint32_t i = 0; i < w->operations; i++){
+        data[i & 511] = (uint8_t) i;
+        sendDMX(data);
+    }
+}
+
+//one operation is a transaction of 16 channels
+static void transactionLoop(worker *w){
+    uint16_t first = 1 + w->index * 128;
+    for(uint32_t i = 0; i < w->operations; i++){
+        dmxBegin();
+        for(int slot = 0; slot < 16; slot++){
+            sendAddress(first + slot, (uint8_t) (i + slot));
+        }
+        dmxCommit();
+    }
+}
+
+/* receive side */
+
+static void readAddressLoop(worker *w){
+    for(uint32_t i = 0; i < w->operations; i++){
+        w->checksum += readAddress(1 + (i & 511));
+    }
+}
+
+static void readFixtureLoop(worker *w){
+    for(uint32_t i = 0; i < w->operations; i++){
+        uint8_t *fixture = readFixture(1 + (i & 255), FIXTURE_FOOTPRINT);
+        w->checksum += fixture[0];
+        free(fixture);
+    }
+}
+
+static void readFixtureIntoLoop(worker *w){
+    uint8_t fixture[FIXTURE_FOOTPRINT];
+    for(uint32_t i = 0; i < w->operations; i++){
+        readFixtureInto(1 + (i & 255), FIXTURE_FOOTPRINT, fixture);
+        w->checksum += fixture[0];
+    }
+}
+
+static void fixtureViewLoop(worker *w){
+    uint8_t storage[FIXTURE_FOOTPRINT];
+    dmxFixtureView view;
+    dmxFixtureViewInit(&view, 1 + w->index * FIXTURE_FOOTPRINT, FIXTURE_FOOTPRINT, storage);
+    for(uint32_t i = 0; i < w->operations; i++){
+        w->checksum += dmxFixtureViewUpdate(dmxGetDefault(), &view);
+    }
+}
+
+static void acquireFrameLoop(worker *w){
+    for(uint32_t i = 0; i < w->operations; i++){
+        const dmxRxFrame *frame = readDMXFrame();
+        w->checksum += frame->packet[1 + (i & 511)];
+        releaseDMXFrame(frame);
+    }
+}
+
+/* kernels */
+
+static void benchSnapshot(){
+    static dmxTxFrame frame;
+    static uint8_t destination[512];
+    uint32_t sequence = 0;
+    const uint32_t operations = 2000000;
+
+    dmxTxFrameInit(&frame);
+    double start = nowSeconds();
+    for(uint32_t i = 0; i < operations; i++){
+        dmxTxFrameSnapshot(&frame, destination, &sequence);
+    }
+    report("kernel", "tx_snapshot_unchanged", 1, operations, nowSeconds() - start);
+
+    start = nowSeconds();
+    for(uint32_t i = 0; i < operations; i++){
+        dmxTxFrameSetSlot(&frame, i & 511, (uint8_t) i);
+        dmxTxFrameSnapshot(&frame, destination, &sequence);
+    }
+    report("kernel", "tx_snapshot_changed", 1, operations, nowSeconds() - start);
+}
+
+static void benchPublish(){
+    static dmxRxBuffer buffer;
+    const uint32_t operations = 1000000;
+    uint32_t checksum = 0;
+
+    dmxRxBufferInit(&buffer);
+    double start = nowSeconds();
+    for(uint32_t i = 0; i < operations; i++){
+        uint8_t *packet = dmxRxBufferWritePacket(&buffer);
+        packet[1 + (i & 511)] = (uint8_t) i; //one changed channel, like a fader move
+        dmxRxBufferPublish(&buffer, 513, i);
+    }
+    report("kernel", "rx_publish_512", 1, operations, nowSeconds() - start);
+
+    start = nowSeconds();
+    for(uint32_t i = 0; i < operations; i++){
+        const dmxRxFrame *frame = dmxRxBufferAcquire(&buffer);
+        checksum += frame->packet[1];
+        dmxRxBufferRelease(&buffer, frame);
+    }
+    report("kernel", "rx_acquire_release", 1, operations, nowSeconds() - start + (checksum == UINT32_MAX));
+}
+
+static uint8_t* countFrame(void *context, uint8_t *packet, uint16_t length){
+    (void) length;
+    (*(uint32_t*) context)++;
+    return packet;
+}
+
+//frames as the UART interrupt hands them to the decoder: FIFO sized chunks, then the break of the next frame
+static void benchDecoder(const char *name, uint16_t slots){
+    static uint8_t stream[513];
+    static uint8_t packet[513];
+    dmxDecoder decoder;
+    uint32_t frames = 0;
+    const uint32_t operations = slots > 100 ? 200000 : 2000000;
+
+    for(int i = 1; i <= slots; i++){
+        stream[i] = (uint8_t) (i * 7);
+    }
+    dmxDecoderInit(&decoder, packet, countFrame, &frames);
+    dmxDecoderBreak(&decoder);
+
+    double start = nowSeconds();
+    for(uint32_t i = 0; i < operations; i++){
+        for(int offset = 0; offset <= slots; offset += FIFO_LEN){
+            int length = slots + 1 - offset;
+            dmxDecoderBytes(&decoder, &stream[offset], length < FIFO_LEN ? length : FIFO_LEN);
+        }
+        dmxDecoderBreak(&decoder);
+    }
+    report("kernel", name, 1, frames, nowSeconds() - start);
+}
+
+/* setup */
+
+static uint8_t patternValue(int slot){
+    return (uint8_t) (slot * 7 + 3);
+}
+
+static int benchSend(){
+    static const dmxSendMode modes[] = {DMX_SEND_PERIODIC, DMX_SEND_ON_CHANGE};
+    static const char *modeNames[] = {"periodic", "on_change"};
+    char name[48];
+
+    setupDMX((dmxPinout) {GPIO_NUM_17, GPIO_NUM_16, GPIO_NUM_4});
+    if(initDMX(true) != ESP_OK){
+        return 1;
+    }
+    for(int mode = 0; mode < 2; mode++){
+        dmxSetSendMode(modes[mode]);
+        for(int threads = 1; threads <= MAX_THREADS; threads *= 2){
+            snprintf(name, sizeof(name), "sendAddress/%s", modeNames[mode]);
+            runThreads("send", name, threads, 2000000, sendAddressLoop);
+            snprintf(name, sizeof(name), "sendDMX/%s", modeNames[mode]);
+            runThreads("send", name, threads, 200000, sendDMXLoop);
+            snprintf(name, sizeof(name), "transaction16/%s", modeNames[mode]);
+            runThreads("send", name, threads, 200000, transactionLoop);
+        }
+    }
+    return 0;
+}
+
+static int benchReceive(){
+    dmxConfig streamConfig = {.port = UART_NUM_1, .pinout = {GPIO_NUM_18, GPIO_NUM_19, GPIO_NUM_5}, .send = true, .refreshRate = 40};
+    dmx_handle_t stream;
+    uint8_t data[512];
+
+    dmxHostConnect(UART_NUM_1, UART_NUM_2);
+    if(initDMX(false) != ESP_OK || dmxCreate(&streamConfig, &stream) != ESP_OK){
+        return 1;
+    }
+    for(int slot = 1; slot <= 512; slot++){
+        data[slot - 1] = patternValue(slot);
+    }
+    dmxWrite(stream, data);
+    dmxHostSleepUntil(esp_timer_get_time() + 100000);
+
+    int failed = 0;
+    for(int slot = 1; slot <= 512; slot++){
+        if(readAddress(slot) != patternValue(slot)){
+            fprintf(stderr, "readAddress(%d): %u instead of %u\n", slot, readAddress(slot), patternValue(slot));
+            failed = 1;
+            break;
+        }
+    }
+
+    for(int threads = 1; threads <= MAX_THREADS; threads *= 2){
+        runThreads("receive", "readAddress", threads, 5000000, readAddressLoop);
+        runThreads("receive", "readFixture16", threads, 1000000, readFixtureLoop);
+        runThreads("receive", "readFixtureInto16", threads, 2000000, readFixtureIntoLoop);
+        runThreads("receive", "fixtureViewUpdate16", threads, 2000000, fixtureViewLoop);
+        runThreads("receive", "readDMXFrame", threads, 2000000, acquireFrameLoop);
+    }
+
+    dmxStats stats;
+    dmxGetStats(dmxGetDefault(), &stats);
+    if(stats.framesReceived == 0 || stats.frameErrors != 0 || stats.bufferFull != 0){
+        fprintf(stderr, "receiver: %u frames, %u framing errors, %u full\n", stats.framesReceived, stats.frameErrors, stats.bufferFull);
+        failed = 1;
+    }
+    dmxDelete(stream);
+    return failed;
+}
+
+int main(){
+    int failed = 0;
+
+    printf("group,name,threads,operations,ns_per_op,ops_per_s\n");
+    failed |= benchSend();
+    failed |= benchReceive();
+    benchSnapshot();
+    benchPublish();
+    benchDecoder("decode_512", 512);
+    benchDecoder("decode_24", 24);
+    return failed;
+}
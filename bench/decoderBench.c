@@ -0,0 +1,203 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Feeds synthetic break / byte streams into the receive decoder, the same way the UART
+// interrupt does (FIFO sized chunks). Every scenario checks that each frame is published
+// exactly once with the right content before the decode time per frame is measured.
+// Frames with alternate start codes are either skipped or routed to their own publisher,
+// SIPs there are checked with dmxParseSip(). Short and long (more than 512 slots) frames are counted.
+
+#include "dmxDecoder.h"
+#include "dmxStartCode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIFO_LEN 128
+#define FRAMES 20000
+
+typedef struct published {
+    uint8_t buffers[2][513];
+    uint8_t alternate[513];
+    uint32_t frames;
+    uint32_t alternateFrames;
+    uint32_t validSips;
+    uint32_t mismatches;
+    uint16_t expectedLength;
+    uint8_t expectedSeed;
+    uint32_t expectedShort; // null start code frames with less than 512 slots
+    uint32_t expectedLong; // null start code frames followed by extra slots
+} published;
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint8_t slotValue(uint8_t seed, int slot){
+    return (uint8_t) (seed * 31 + slot * 7);
+}
+
+static uint8_t* onFrame(void *context, uint8_t *packet, uint16_t length){
+    published *out = context;
+
+    if(length != out->expectedLength || packet[0] != 0x00){
+        out->mismatches++;
+    } else{
+        for(int slot = 1; slot < length; slot++){
+            if(packet[slot] != slotValue(out->expectedSeed, slot)){
+                out->mismatches++;
+                break;
+            }
+        }
+    }
+    out->frames++;
+    return packet == out->buffers[0] ? out->buffers[1] : out->buffers[0];
+}
+
+static uint8_t* onAlternateFrame(void *context, uint8_t *packet, uint16_t length){
+    published *out = context;
+    dmxSipPacket sip;
+
+    if(length != out->expectedLength || packet == out->buffers[0] || packet == out->buffers[1]){
+        out->mismatches++; //never decoded into the null start code buffers
+    } else if(packet[0] == DMX_START_CODE_SIP){
+        out->validSips += dmxParseSip(packet, length, &sip) && sip.universe == 7;
+    }
+    out->alternateFrames++;
+    return packet;
+}
+
+//a SIP for universe 7, the checksum is broken if corrupt is set
+static void buildSip(uint8_t *wire, int corrupt){
+    memset(wire, 0, DMX_SIP_LENGTH);
+    wire[0] = DMX_START_CODE_SIP;
+    wire[1] = DMX_SIP_LENGTH - 1;
+    wire[6] = 7;
+    for(int i = 0; i < DMX_SIP_LENGTH - 1; i++){
+        wire[DMX_SIP_LENGTH - 1] += wire[i];
+    }
+    wire[DMX_SIP_LENGTH - 1] += corrupt;
+}
+
+//feeds bytes in FIFO sized chunks of random length, like the RX interrupt does
+static void feedWire(dmxDecoder *decoder, const uint8_t *wire, uint16_t slots){
+    size_t sent = 0;
+    while(sent < (size_t) slots + 1){
+        size_t chunk = 1 + rand() % FIFO_LEN;
+        if(chunk > slots + 1 - sent){
+            chunk = slots + 1 - sent;
+        }
+        dmxDecoderBytes(decoder, &wire[sent], chunk);
+        sent += chunk;
+    }
+}
+
+//feeds one frame after a break
+static void feedFrame(dmxDecoder *decoder, published *out, uint8_t startCode, uint16_t slots, uint8_t seed){
+    uint8_t wire[513];
+    wire[0] = startCode;
+    for(int slot = 1; slot <= slots; slot++){
+        wire[slot] = slotValue(seed, slot);
+    }
+
+    dmxDecoderBreak(decoder); //publishes the previous frame if it was short
+    out->expectedSeed = seed;
+
+    feedWire(decoder, wire, slots);
+}
+
+typedef enum {SCENARIO_FULL, SCENARIO_SHORT, SCENARIO_VARIABLE, SCENARIO_ALTERNATE, SCENARIO_ROUTED, SCENARIO_ERRORS} scenario;
+
+static const char *scenarioNames[] = {"full_512", "short_24", "variable_length", "alternate_start_codes", "routed_start_codes", "framing_errors"};
+
+//returns the number of frames expected to be published
+static uint32_t runScenario(scenario type, dmxDecoder *decoder, published *out){
+    uint32_t expected = 0;
+    uint16_t slots = type == SCENARIO_SHORT ? 24 : 512;
+    out->expectedLength = slots + 1;
+
+    for(int frame = 0; frame < FRAMES; frame++){
+        if(type == SCENARIO_VARIABLE){
+            slots = 1 + rand() % 512;
+            dmxDecoderBreak(decoder); //the previous frame has to be checked with its own length
+            out->expectedLength = slots + 1;
+        }
+        if(type == SCENARIO_ALTERNATE && frame % 4 == 3){
+            feedFrame(decoder, out, 0xCF, slots, (uint8_t) frame); //never published
+            continue;
+        }
+        if(type == SCENARIO_ROUTED && frame % 4 == 3){
+            uint8_t sip[DMX_SIP_LENGTH];
+            buildSip(sip, frame % 8 == 7);
+            dmxDecoderBreak(decoder);
+            out->expectedLength = DMX_SIP_LENGTH;
+            feedWire(decoder, sip, DMX_SIP_LENGTH - 1);
+            dmxDecoderBreak(decoder); //a SIP is short, it's complete with the next break
+            out->expectedLength = slots + 1;
+            continue;
+        }
+        if(type == SCENARIO_ERRORS && frame % 10 == 9){
+            uint8_t half[256];
+            memset(half, 0x11, sizeof(half));
+            dmxDecoderBreak(decoder);
+            dmxDecoderBytes(decoder, half, sizeof(half));
+            dmxDecoderError(decoder); //the frame in progress is dropped
+            dmxDecoderBytes(decoder, half, sizeof(half)); //garbage until the next break
+            continue;
+        }
+
+        feedFrame(decoder, out, 0x00, slots, (uint8_t) frame);
+        if(slots < 512){
+            out->expectedShort++;
+        }
+        if(type == SCENARIO_FULL && frame % 100 == 99){
+            static const uint8_t extra[4] = {0xEE, 0xEE, 0xEE, 0xEE};
+            dmxDecoderBytes(decoder, extra, sizeof(extra)); //slots beyond 512, dropped and counted once
+            out->expectedLong++;
+        }
+        expected++;
+    }
+    dmxDecoderBreak(decoder); //completes a trailing short frame
+    return expected;
+}
+
+int main(){
+    static published out;
+    int failed = 0;
+
+    srand(1);
+    printf("scenario,frames_fed,frames_published,frames_expected,mismatches,dropped,short_frames,long_frames,ns_per_frame\n");
+    for(scenario type = SCENARIO_FULL; type <= SCENARIO_ERRORS; type++){
+        dmxDecoder decoder;
+        memset(&out, 0, sizeof(out));
+        dmxDecoderInit(&decoder, out.buffers[0], onFrame, &out);
+        if(type == SCENARIO_ROUTED){
+            dmxDecoderSetAlternate(&decoder, out.alternate, onAlternateFrame);
+        }
+
+        double start = nowSeconds();
+        uint32_t expected = runScenario(type, &decoder, &out);
+        double elapsed = nowSeconds() - start;
+
+        int32_t dropped = (int32_t) (expected - out.frames);
+        printf("%s,%u,%u,%u,%u,%d,%u,%u,%.0f\n", scenarioNames[type], FRAMES, out.frames, expected, out.mismatches, dropped,
+               decoder.stats.shortFrames, decoder.stats.longFrames, elapsed * 1e9 / FRAMES);
+        if(type == SCENARIO_ROUTED && (out.alternateFrames != FRAMES / 4 || out.validSips != FRAMES / 8)){
+            failed = 1;
+        }
+        if(decoder.stats.shortFrames != out.expectedShort || decoder.stats.longFrames != out.expectedLong){
+            failed = 1;
+        }
+        if(dropped != 0 || out.mismatches != 0){
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Compares the word-wide (SWAR) frame change detection against the byte by byte reference.
+// Every change pattern is checked for an identical bitmap, count and range list first,
+// the benchmark only runs if all of them match.
+
+#include "dmxDiff.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ITERATIONS 200000
+
+static uint8_t packet[513] __attribute__((aligned(4)));
+static uint8_t previous[513] __attribute__((aligned(4)));
+
+typedef uint16_t (*diffFunction)(const uint8_t *packet, const uint8_t *previous, uint16_t length, dmxDirtyMap *map);
+
+typedef enum {PATTERN_NONE, PATTERN_ONE, PATTERN_FIXTURES, PATTERN_RANDOM, PATTERN_ALL} pattern;
+
+static const char *patternNames[] = {"unchanged", "one_slot", "16_fixtures", "random_25_percent", "all_slots"};
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void preparePackets(pattern type){
+    for(int slot = 0; slot < 513; slot++){
+        previous[slot] = rand();
+    }
+    memcpy(packet, previous, sizeof(packet));
+
+    switch(type){
+        case PATTERN_ONE:
+            packet[300] ^= 0x01;
+            break;
+        case PATTERN_FIXTURES: //16 RGB fixtures spread over the universe
+            for(int fixture = 0; fixture < 16; fixture++){
+                for(int channel = 0; channel < 3; channel++){
+                    packet[1 + fixture * 32 + channel] ^= 0x80;
+                }
+            }
+            break;
+        case PATTERN_RANDOM:
+            for(int slot = 1; slot < 513; slot++){
+                if(rand() % 4 == 0){
+                    packet[slot] ^= 1 + rand() % 255;
+                }
+            }
+            break;
+        case PATTERN_ALL:
+            for(int slot = 1; slot < 513; slot++){
+                packet[slot] = ~previous[slot];
+            }
+            break;
+        case PATTERN_NONE:
+        default:
+            break;
+    }
+}
+
+static int checkIdentical(){
+    const uint16_t lengths[] = {1, 2, 9, 25, 100, 512, 513};
+
+    for(int trial = 0; trial < 2000; trial++){
+        for(size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++){
+            dmxDirtyMap reference;
+            dmxDirtyMap optimized;
+            preparePackets((pattern) (trial % (PATTERN_ALL + 1)));
+            packet[0] = trial & 1; //start code changes are never reported
+
+            uint16_t referenceChanged = dmxDiffPacketsScalar(packet, previous, lengths[i], &reference);
+            uint16_t optimizedChanged = dmxDiffPackets(packet, previous, lengths[i], &optimized);
+
+            if(referenceChanged != optimizedChanged || memcmp(reference.bits, optimized.bits, sizeof(reference.bits)) != 0
+               || reference.rangeCount != optimized.rangeCount
+               || memcmp(reference.ranges, optimized.ranges, reference.rangeCount * sizeof(dmxDirtyRange)) != 0
+               || (reference.bits[0] & 1) != 0){
+                fprintf(stderr, "mismatch: trial %d, length %u\n", trial, lengths[i]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static double benchmark(diffFunction diff){
+    static dmxDirtyMap map;
+    volatile uint32_t sink = 0;
+
+    double start = nowSeconds();
+    for(int i = 0; i < ITERATIONS; i++){
+        sink += diff(packet, previous, 513, &map);
+    }
+    return (nowSeconds() - start) * 1e9 / ITERATIONS;
+}
+
+int main(){
+    srand(1);
+    if(checkIdentical() != 0){
+        return 1;
+    }
+
+    printf("pattern,changed_slots,ranges,ns_per_frame_bytewise,ns_per_frame_swar,speedup\n");
+    for(pattern type = PATTERN_NONE; type <= PATTERN_ALL; type++){
+        dmxDirtyMap map;
+        preparePackets(type);
+        dmxDiffPackets(packet, previous, 513, &map);
+
+        double bytewise = benchmark(dmxDiffPacketsScalar);
+        double swar = benchmark(dmxDiffPackets);
+        printf("%s,%u,%u,%.1f,%.1f,%.2f\n", patternNames[type], map.changed, map.rangeCount, bytewise, swar, bytewise / swar);
+    }
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Generates synthetic line edge streams (80MHz timestamps, so they wrap around during the run) with
+// different break, mark after break, inter-slot and mark before break times and feeds them into the
+// edge decoder, once as edges and once as level / duration runs like RMT symbols deliver them.
+// Every frame is checked for its content and measured timing before the decode time per frame is
+// compared against the frame period (a continuous stream has to be decoded faster than it arrives).
+
+#include "dmxEdgeDecoder.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TICKS_PER_US 80
+#define PREAMBLE_TICKS (1000 * TICKS_PER_US) // idle line before the first break
+#define CHECK_FRAMES 200
+#define CYCLE_FRAMES 8
+#define ITERATIONS 500
+#define MAX_EDGES (CYCLE_FRAMES * 513 * 10 + 64)
+
+typedef struct scenario {
+    const char *name;
+    uint32_t breakUs;
+    uint32_t mabUs;
+    uint32_t gapUs; // mark between slots
+    uint32_t mbbUs;
+    uint16_t slots;
+    uint32_t bitTicks; // 320 at 250 kbaud
+    int worstCase; // every slot 0x55: an edge on every bit
+} scenario;
+
+typedef struct edge {
+    uint32_t timestamp;
+    uint8_t level;
+} edge;
+
+typedef struct generator {
+    edge *edges;
+    uint32_t count;
+    uint32_t time;
+    uint8_t level;
+} generator;
+
+typedef struct published {
+    uint8_t buffer[513];
+    const scenario *scenario;
+    uint32_t frames;
+    uint32_t mismatches;
+    uint32_t timingErrors;
+    dmxFrameTiming last;
+} published;
+
+static edge edges[MAX_EDGES];
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint8_t slotValue(const scenario *s, uint32_t frame, int slot){
+    if(s->worstCase){
+        return 0x55;
+    }
+    return (uint8_t) (frame * 31 + slot * 7 + (slot >> 3));
+}
+
+static void level(generator *gen, uint8_t value, uint32_t ticks){
+    if(value != gen->level || gen->count == 0){
+        gen->edges[gen->count].timestamp = gen->time;
+        gen->edges[gen->count].level = value;
+        gen->count++;
+        gen->level = value;
+    }
+    gen->time += ticks;
+}
+
+static void slot(generator *gen, const scenario *s, uint8_t value){
+    level(gen, 0, s->bitTicks);
+    for(int bit = 0; bit < 8; bit++){
+        level(gen, (value >> bit) & 1, s->bitTicks);
+    }
+    level(gen, 1, 2 * s->bitTicks);
+}
+
+static void frame(generator *gen, const scenario *s, uint32_t number){
+    level(gen, 0, s->breakUs * TICKS_PER_US);
+    level(gen, 1, s->mabUs * TICKS_PER_US);
+    for(int i = 0; i <= s->slots; i++){
+        slot(gen, s, i == 0 ? 0x00 : slotValue(s, number, i));
+        if(i < s->slots){
+            level(gen, 1, s->gapUs * TICKS_PER_US);
+        }
+    }
+    level(gen, 1, s->mbbUs * TICKS_PER_US);
+}
+
+static uint32_t framePeriodTicks(const scenario *s){
+    return (s->breakUs + s->mabUs + s->mbbUs + s->gapUs * s->slots) * TICKS_PER_US + (s->slots + 1) * 11 * s->bitTicks;
+}
+
+static int near(uint32_t measured, uint32_t expected, uint32_t tolerance){
+    return measured + tolerance >= expected && measured <= expected + tolerance;
+}
+
+static uint8_t* onFrame(void *context, uint8_t *packet, uint16_t length, const dmxFrameTiming *timing){
+    published *p = context;
+    const scenario *s = p->scenario;
+    uint32_t bitNs = s->bitTicks * 1000 / TICKS_PER_US;
+
+    if(length != s->slots + 1 || packet[0] != 0x00){
+        p->mismatches++;
+    } else{
+        for(int i = 1; i < length; i++){
+            if(packet[i] != slotValue(s, p->frames, i)){
+                p->mismatches++;
+                break;
+            }
+        }
+    }
+
+    //the decoder assumes 4µs bits for the end of the last slot, a baud rate deviation shifts the mark before break
+    uint32_t mbbTolerance = 11 * (bitNs > 4000 ? bitNs - 4000 : 4000 - bitNs) + 1;
+    if(timing->breakNs != s->breakUs * 1000 || timing->mabNs != s->mabUs * 1000
+       || !near(timing->slotNs, 11 * bitNs + s->gapUs * 1000, 1) || !near(timing->maxSlotNs, 11 * bitNs + s->gapUs * 1000, 1)
+       || !near(timing->mbbNs, s->mbbUs * 1000, mbbTolerance) || !near(timing->periodNs, (uint64_t) framePeriodTicks(s) * 1000 / TICKS_PER_US, 1)){
+        p->timingErrors++;
+    }
+    p->last = *timing;
+    p->frames++;
+    return packet;
+}
+
+//frames 0 - count-1 followed by the break of the next one
+static void generate(generator *gen, const scenario *s, uint32_t count){
+    gen->edges = edges;
+    gen->count = 0;
+    gen->level = 1;
+    level(gen, 1, PREAMBLE_TICKS);
+    for(uint32_t i = 0; i < count; i++){
+        frame(gen, s, i);
+    }
+    level(gen, 0, s->breakUs * TICKS_PER_US);
+    level(gen, 1, 0);
+}
+
+static int check(const scenario *s, int runs){
+    static published p;
+    dmxEdgeDecoder decoder;
+    generator gen;
+    uint32_t offset = 0xFFFFFFFF - 10000000; //wraps around within the first frames
+
+    memset(&p, 0, sizeof(p));
+    p.scenario = s;
+    dmxEdgeDecoderInit(&decoder, TICKS_PER_US, p.buffer, onFrame, &p);
+
+    for(uint32_t block = 0; block < CHECK_FRAMES / CYCLE_FRAMES; block++){
+        //every block starts with frame 0 again, the decoder is reset in between
+        generate(&gen, s, CYCLE_FRAMES);
+        dmxEdgeDecoderInit(&decoder, TICKS_PER_US, p.buffer, onFrame, &p);
+        uint32_t base = p.frames;
+        p.frames = 0;
+        for(uint32_t i = 0; i < gen.count; i++){
+            if(runs){
+                if(i + 1 < gen.count){
+                    dmxEdgeDecoderRun(&decoder, edges[i].level, edges[i + 1].timestamp - edges[i].timestamp);
+                }
+            } else{
+                dmxEdgeDecoderEdge(&decoder, edges[i].timestamp + offset, edges[i].level);
+            }
+        }
+        if(p.frames != CYCLE_FRAMES || decoder.stats.errors != 0){
+            fprintf(stderr, "%s: %u of %u frames, %u errors\n", s->name, p.frames, CYCLE_FRAMES, decoder.stats.errors);
+            return 1;
+        }
+        p.frames += base;
+        offset += gen.time;
+    }
+
+    if(p.mismatches != 0 || p.timingErrors != 0){
+        fprintf(stderr, "%s: %u content mismatches, %u timing errors (break %u mab %u slot %u/%u mbb %u period %u ns)\n", s->name,
+                p.mismatches, p.timingErrors, p.last.breakNs, p.last.mabNs, p.last.slotNs, p.last.maxSlotNs, p.last.mbbNs, p.last.periodNs);
+        return 1;
+    }
+    return 0;
+}
+
+static uint8_t* discard(void *context, uint8_t *packet, uint16_t length, const dmxFrameTiming *timing){
+    (void) length;
+    (void) timing;
+    (*(uint32_t*) context)++;
+    return packet;
+}
+
+int main(){
+    static const scenario scenarios[] = {
+        {"minimum_timing", 92, 12, 0, 0, 512, 320, 0},
+        {"typical", 176, 16, 4, 100, 512, 320, 0},
+        {"slow_console", 1000, 100, 40, 2000, 512, 320, 0},
+        {"short_frame", 120, 12, 0, 0, 24, 320, 0},
+        {"baud_plus_2pct", 176, 12, 0, 50, 512, 314, 0},
+        {"baud_minus_2pct", 176, 12, 0, 50, 512, 326, 0},
+        {"worst_case_edges", 92, 12, 0, 0, 512, 320, 1},
+    };
+    static uint8_t buffer[513];
+    int failed = 0;
+
+    printf("scenario,slots,edges_per_frame,ns_per_frame,frame_period_us,realtime_factor\n");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++){
+        const scenario *s = &scenarios[i];
+        if(check(s, 0) || check(s, 1)){
+            failed = 1;
+            continue;
+        }
+
+        generator gen;
+        dmxEdgeDecoder decoder;
+        uint32_t frames = 0;
+        generate(&gen, s, CYCLE_FRAMES);
+        dmxEdgeDecoderInit(&decoder, TICKS_PER_US, buffer, discard, &frames);
+
+        //the stream repeats after gen.time ticks, the closing break is dropped so the next cycle continues it
+        uint32_t count = gen.count - 2;
+        uint32_t offset = 0;
+        double start = nowSeconds();
+        for(int iteration = 0; iteration < ITERATIONS; iteration++){
+            for(uint32_t e = 0; e < count; e++){
+                dmxEdgeDecoderEdge(&decoder, edges[e].timestamp + offset, edges[e].level);
+            }
+            offset += gen.time - s->breakUs * TICKS_PER_US - PREAMBLE_TICKS;
+        }
+        double elapsed = nowSeconds() - start;
+
+        if(frames < (uint32_t) ITERATIONS * CYCLE_FRAMES - 1 || decoder.stats.errors != 0){
+            fprintf(stderr, "%s: continuous stream lost frames (%u, %u errors)\n", s->name, frames, decoder.stats.errors);
+            failed = 1;
+        }
+
+        double nsPerFrame = elapsed * 1e9 / ((double) ITERATIONS * CYCLE_FRAMES);
+        double periodUs = framePeriodTicks(s) / (double) TICKS_PER_US;
+        printf("%s,%u,%u,%.0f,%.0f,%.0f\n", s->name, s->slots, count / CYCLE_FRAMES, nsPerFrame, periodUs, periodUs * 1000 / nsPerFrame);
+        if(nsPerFrame > periodUs * 1000){
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
@@ -0,0 +1,234 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Feeds a receiving instance on the Linux port with deterministic line streams that carry one kind of fault
+// at a few frames each: short breaks, breaks inside a frame, truncated frames, framing errors, jittered
+// mark after break, back to back frames and garbage between frames. Every frame is tagged (slot 1: number,
+// slot 2: inverted number), so the frames the receiver published can be matched against the sent ones.
+// Per fault type the frames lost, the frames published with missing slots, and the time valid output
+// resumed later than it would have on a clean line (relock, 0 if no frame was lost) are reported.
+// Published frames with wrong slot values, or losses on a line a UART receives correctly, fail the run.
+
+#include "dmx4esp.h"
+#include "dmxHost.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAMES 45
+#define SLOTS 512
+#define FAULT_EVERY 10 // faults at frames 5, 15, 25, 35
+#define FAULT_OFFSET 5
+#define MAX_SYMBOLS (FRAMES * (SLOTS + 64))
+#define TIME_SCALE 4.0 // the bus runs ahead of real time, only wire times are evaluated
+
+#define BREAK_US 176
+#define MAB_US 16
+#define MBB_US 100
+
+typedef enum {
+    FAULT_NONE,
+    FAULT_SHORT_BREAK, // 60µs break: below the 88µs minimum, still a break for the UART
+    FAULT_BREAK_IN_FRAME, // 60µs low in the middle of the slots
+    FAULT_TRUNCATED, // frame ends after 100 slots, the next break follows
+    FAULT_FRAMING_ERROR, // slot 256 without stop bit
+    FAULT_JITTERED_MAB, // 4 - 12µs mark after break (otherwise 12 - 100µs)
+    FAULT_BACK_TO_BACK, // no mark before break, 88µs break and 8µs mark after break
+    FAULT_GARBAGE // 24 random bytes in the mark before break
+} faultType;
+
+typedef struct scenario {
+    const char *name;
+    faultType fault;
+    int lossless; // a UART receives every frame of this line, losses are failures
+} scenario;
+
+typedef struct stream {
+    dmxHostSymbol symbols[MAX_SYMBOLS];
+    size_t count;
+    int64_t time; // µs since the start of the stream
+    int64_t frameEnd[FRAMES]; // end of the last slot on the wire
+    uint32_t random;
+} stream;
+
+typedef struct received {
+    uint8_t intact[FRAMES];
+    uint32_t shortFrames; // prefix of a sent frame, the missing slots read as 0
+    uint32_t corrupt; // slot values of no sent frame
+} received;
+
+static stream line;
+
+static uint32_t nextRandom(stream *s){
+    s->random ^= s->random << 13;
+    s->random ^= s->random >> 17;
+    s->random ^= s->random << 5;
+    return s->random;
+}
+
+static uint8_t slotValue(int frame, int slot){
+    if(slot == 1){
+        return (uint8_t) frame;
+    }
+    return slot == 2 ? (uint8_t) ~frame : (uint8_t) (frame * 31 + slot);
+}
+
+static void emit(stream *s, dmxHostSymbolType type, uint8_t value, uint32_t durationUs){
+    s->symbols[s->count++] = (dmxHostSymbol) {.type = type, .value = value, .durationUs = durationUs};
+    s->time += durationUs != 0 ? durationUs : DMX_HOST_BYTE_US;
+}
+
+//jitter: mark after break of the frames without fault varies as well
+static void frame(stream *s, int number, faultType fault, int jitter){
+    uint32_t breakUs = BREAK_US;
+    uint32_t mabUs = MAB_US;
+    uint16_t slots = SLOTS;
+
+    if(fault == FAULT_SHORT_BREAK){
+        breakUs = 60;
+    } else if(fault == FAULT_BACK_TO_BACK){
+        breakUs = 88;
+        mabUs = 8;
+    }
+    if(fault == FAULT_JITTERED_MAB){
+        mabUs = 4 + nextRandom(s) % 9;
+    } else if(jitter){
+        mabUs = 12 + nextRandom(s) % 89;
+    }
+    if(fault == FAULT_TRUNCATED){
+        slots = 100;
+    }
+
+    emit(s, DMX_HOST_BREAK, 0, breakUs);
+    emit(s, DMX_HOST_MARK, 0, mabUs);
+    emit(s, DMX_HOST_BYTE, 0x00, 0);
+    for(int slot = 1; slot <= slots; slot++){
+        if(slot == 256 && fault == FAULT_FRAMING_ERROR){
+            emit(s, DMX_HOST_FRAMING_ERROR, slotValue(number, slot), 0);
+            continue;
+        }
+        if(slot == 256 && fault == FAULT_BREAK_IN_FRAME){
+            emit(s, DMX_HOST_BREAK, 0, 60);
+            emit(s, DMX_HOST_MARK, 0, 8);
+        }
+        emit(s, DMX_HOST_BYTE, slotValue(number, slot), 0);
+    }
+    s->frameEnd[number] = s->time;
+
+    if(fault == FAULT_GARBAGE){
+        for(int i = 0; i < 24; i++){
+            emit(s, DMX_HOST_BYTE, (uint8_t) nextRandom(s), 0);
+            emit(s, DMX_HOST_MARK, 0, nextRandom(s) % 20);
+        }
+    }
+    if(fault != FAULT_BACK_TO_BACK){
+        emit(s, DMX_HOST_MARK, 0, MBB_US);
+    }
+}
+
+static int isFaulted(int number){
+    return number % FAULT_EVERY == FAULT_OFFSET;
+}
+
+static void generate(stream *s, const scenario *sc){
+    s->count = 0;
+    s->time = 0;
+    s->random = 0x2545F491;
+    for(int number = 0; number < FRAMES; number++){
+        frame(s, number, isFaulted(number) ? sc->fault : FAULT_NONE, sc->fault == FAULT_JITTERED_MAB);
+    }
+    emit(s, DMX_HOST_BREAK, 0, BREAK_US); //ends a truncated last frame
+    emit(s, DMX_HOST_MARK, 0, MBB_US);
+}
+
+//runs in the (simulated) UART interrupt
+static void onFrame(dmx_handle_t handle, const dmxRxFrame *frame, void *context){
+    (void) handle;
+    received *r = context;
+    int number = frame->packet[1];
+
+    int matches = frame->packet[0] == 0x00 && frame->length >= 3 && number < FRAMES && frame->packet[2] == (uint8_t) ~number;
+    for(int slot = 3; slot < frame->length && matches; slot++){
+        matches = frame->packet[slot] == slotValue(number, slot);
+    }
+
+    if(!matches){
+        r->corrupt++;
+    } else if(frame->length == SLOTS + 1){
+        r->intact[number] = 1;
+    } else{
+        r->shortFrames++;
+    }
+}
+
+static int run(const scenario *sc){
+    static received r;
+    dmx_handle_t receiver;
+    dmx_subscription_t subscription;
+    dmxConfig config = {.port = UART_NUM_2, .pinout = {GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_4}, .send = false};
+    dmxSubscribeConfig subscribe = {.type = DMX_NOTIFY_BY_CALLBACK, .callback = onFrame, .context = &r};
+
+    memset(&r, 0, sizeof(r));
+    generate(&line, sc);
+    if(dmxCreate(&config, &receiver) != ESP_OK || dmxSubscribe(receiver, &subscribe, &subscription) != ESP_OK){
+        return 1;
+    }
+    dmxHostWireSend(UART_NUM_2, line.symbols, line.count);
+    dmxHostSleepUntil(dmxHostWireIdleAt(UART_NUM_2) + 1000);
+
+    dmxStats stats;
+    dmxGetStats(receiver, &stats);
+    dmxDelete(receiver);
+
+    uint32_t lost = 0;
+    uint32_t faults = 0;
+    int64_t relockSum = 0;
+    int64_t relockMax = 0;
+    for(int number = 0; number < FRAMES; number++){
+        lost += !r.intact[number];
+        if(!isFaulted(number)){
+            continue;
+        }
+        //first frame from the faulted one on that made it
+        int next = number;
+        while(next < FRAMES && !r.intact[next]){
+            next++;
+        }
+        int64_t relock = next < FRAMES ? line.frameEnd[next] - line.frameEnd[number] : line.time - line.frameEnd[number];
+        relockSum += relock;
+        relockMax = relock > relockMax ? relock : relockMax;
+        faults++;
+    }
+
+    int failed = r.corrupt != 0 || (sc->lossless && lost != 0);
+    printf("%s,%u,%u,%u,%.2f,%u,%u,%lld,%lld,%u,%u,%u,%u,%s\n", sc->name, FRAMES, faults, lost, faults > 0 ? (double) lost / faults : 0.0,
+           r.shortFrames, r.corrupt, (long long) (faults > 0 ? relockSum / faults : 0), (long long) relockMax, stats.framesReceived,
+           stats.frameErrors, stats.shortFrames, stats.longFrames, failed ? "FAIL" : "ok");
+    return failed;
+}
+
+int main(){
+    static const scenario scenarios[] = {
+        {"clean", FAULT_NONE, 1},
+        {"short_break", FAULT_SHORT_BREAK, 1},
+        {"break_in_frame", FAULT_BREAK_IN_FRAME, 0},
+        {"truncated_frame", FAULT_TRUNCATED, 0},
+        {"framing_error", FAULT_FRAMING_ERROR, 0},
+        {"jittered_mab", FAULT_JITTERED_MAB, 1},
+        {"back_to_back", FAULT_BACK_TO_BACK, 1},
+        {"garbage_between_frames", FAULT_GARBAGE, 1},
+    };
+    int failed = 0;
+
+    dmxHostSetTimeScale(TIME_SCALE);
+    printf("fault,frames,faults,frames_lost,lost_per_fault,short_published,corrupt_published,relock_avg_us,relock_max_us,"
+           "frames_received,frame_errors,short_frames,long_frames,result\n");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++){
+        failed |= run(&scenarios[i]);
+    }
+    return failed;
+}
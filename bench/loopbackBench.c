@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Runs the complete library on the simulated bus of the Linux port: a sending instance on UART_NUM_1 is
+// connected to a receiving one on UART_NUM_2 and streams changing patterns for a few (virtual) seconds.
+// Every received frame has to carry one complete pattern, the receive rate has to match the send rate
+// and neither side may count an error.
+// Then dmxSelfTest() runs over the same link (periodic and on change, with 0x55 network test packets): no pattern,
+// frame or test packet may be lost, every test packet has to reach a start code handler, no slot may differ, and the
+// median commit to receive latency has to stay below one frame period plus the frame time (periodic) or twice the
+// frame time (on change).
+// 512 slots at 44Hz run at the wire time limit (43.8Hz): periodic send rates have to reach 90% of the clamped target.
+
+#include "dmx4esp.h"
+#include "dmxHost.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdatomic.h>
+
+#define RUN_US 2000000
+#define PATTERN_US 50000 // a new pattern every 50ms
+#define TIME_SCALE 0.5 // the bus runs at half speed, so task wakeups on a loaded (or single core) host stay in time
+
+typedef struct scenario {
+    const char *name;
+    dmxSendMode sendMode;
+    uint16_t refreshRate;
+    uint16_t slotCount;
+} scenario;
+
+typedef struct received {
+    uint16_t slots;
+    atomic_uint frames;
+    atomic_uint torn; // slots of different patterns or a wrong length
+} received;
+
+static uint8_t patternValue(uint8_t pattern, int slot){
+    return slot == 1 ? pattern : (uint8_t) (pattern * 13 + slot);
+}
+
+//runs in the (simulated) UART interrupt
+static void onFrame(dmx_handle_t handle, const dmxRxFrame *frame, void *context){
+    (void) handle;
+    received *r = context;
+    uint8_t pattern = frame->packet[1];
+    int torn = frame->length != r->slots + 1 || frame->packet[0] != 0x00;
+    for(int slot = 2; slot <= r->slots && !torn; slot++){
+        torn = frame->packet[slot] != patternValue(pattern, slot);
+    }
+    atomic_fetch_add(&r->frames, 1);
+    atomic_fetch_add(&r->torn, torn);
+}
+
+//start code handler of the 0x55 test packets, runs in the (simulated) UART interrupt
+static void onTestPacket(dmx_handle_t handle, const uint8_t *packet, uint16_t length, void *context){
+    (void) handle;
+    (void) packet;
+    (void) length;
+    atomic_fetch_add((atomic_uint*) context, 1);
+}
+
+static int run(const scenario *s){
+    static received r;
+    dmx_handle_t receiver;
+    dmx_handle_t sender;
+    dmx_subscription_t subscription;
+    uint8_t data[512] = {0};
+
+    atomic_store(&r.frames, 0);
+    atomic_store(&r.torn, 0);
+    r.slots = s->slotCount;
+
+    dmxConfig rxConfig = {.port = UART_NUM_2, .pinout = {GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_4}, .send = false};
+    dmxConfig txConfig = {.port = UART_NUM_1, .pinout = {GPIO_NUM_18, GPIO_NUM_19, GPIO_NUM_5}, .send = true,
+                          .sendMode = s->sendMode, .refreshRate = s->refreshRate, .slotCount = s->slotCount};
+    dmxSubscribeConfig subscribe = {.type = DMX_NOTIFY_BY_CALLBACK, .callback = onFrame, .context = &r};
+    dmxHostRxStats busBefore;
+    dmxHostRxStats bus;
+
+    dmxHostConnect(UART_NUM_1, UART_NUM_2);
+    dmxHostGetRxStats(UART_NUM_2, &busBefore);
+    if(dmxCreate(&rxConfig, &receiver) != ESP_OK || dmxSubscribe(receiver, &subscribe, &subscription) != ESP_OK){
+        return 1;
+    }
+    for(int slot = 1; slot <= 512; slot++){
+        data[slot - 1] = patternValue(0, slot);
+    }
+    if(dmxCreate(&txConfig, &sender) != ESP_OK){
+        return 1;
+    }
+    dmxWrite(sender, data);
+
+    int64_t start = esp_timer_get_time();
+    for(uint8_t pattern = 1; esp_timer_get_time() - start < RUN_US; pattern++){
+        dmxHostSleepUntil(start + (int64_t) pattern * PATTERN_US);
+        for(int slot = 1; slot <= 512; slot++){
+            data[slot - 1] = patternValue(pattern, slot);
+        }
+        dmxWrite(sender, data);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    dmxStats txStats;
+    dmxStats rxStats;
+    dmxRefreshStats refresh;
+    dmxGetStats(sender, &txStats);
+    dmxGetTransmitStats(sender, &refresh);
+    dmxDelete(sender);
+    dmxHostSleepUntil(dmxHostWireIdleAt(UART_NUM_2) + 1000); //frame on the wire arrives
+    dmxGetStats(receiver, &rxStats);
+    dmxHostGetRxStats(UART_NUM_2, &bus);
+    dmxDelete(receiver);
+
+    unsigned frames = atomic_load(&r.frames);
+    unsigned torn = atomic_load(&r.torn);
+    uint32_t errors = rxStats.frameErrors + rxStats.parityErrors + rxStats.fifoOverflows + rxStats.bufferFull + rxStats.longFrames
+                      + (s->slotCount == 512 ? rxStats.shortFrames : 0);
+    double sendRate = txStats.framesSent * 1e6 / elapsed;
+    //short frames are only published at the next break, and the sender may be deleted during the break of a counted frame
+    int failed = frames == 0 || torn != 0 || errors != 0 || rxStats.framesReceived + 2 < txStats.framesSent
+                 || rxStats.framesReceived > txStats.framesSent || (s->sendMode == DMX_SEND_PERIODIC && sendRate < refresh.targetRate * 0.9);
+
+    printf("%s,%u,%u,%u,%u,%.1f,%.1f,%u,%u,%u,%u,%u,%s\n", s->name, s->slotCount, s->refreshRate, txStats.framesSent,
+           rxStats.framesReceived, sendRate, rxStats.refreshRate, rxStats.avgIntervalUs, refresh.overruns, torn, errors, bus.interrupts - busBefore.interrupts,
+           failed ? "FAIL" : "ok");
+    return failed;
+}
+
+static int selfTest(const char *name, dmxSendMode sendMode){
+    dmx_handle_t receiver;
+    dmx_handle_t sender;
+    dmxConfig rxConfig = {.port = UART_NUM_2, .pinout = {GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_4}, .send = false};
+    dmxConfig txConfig = {.port = UART_NUM_1, .pinout = {GPIO_NUM_18, GPIO_NUM_19, GPIO_NUM_5}, .send = true,
+                          .sendMode = sendMode, .refreshRate = 40};
+    dmxSelfTestConfig config = {.patterns = 60, .testPacketInterval = 10};
+    dmxSelfTestResult result;
+    atomic_uint handled = 0;
+
+    dmxHostConnect(UART_NUM_1, UART_NUM_2);
+    if(dmxCreate(&rxConfig, &receiver) != ESP_OK || dmxCreate(&txConfig, &sender) != ESP_OK){
+        return 1;
+    }
+    dmxSetStartCodeHandler(receiver, 0x55, onTestPacket, &handled);
+    esp_err_t error = dmxSelfTest(sender, receiver, &config, &result);
+    dmxSetStartCodeHandler(receiver, 0x55, NULL, NULL);
+    dmxDelete(sender);
+    dmxDelete(receiver);
+
+    const uint32_t frameUs = 176 + 12 + 513 * DMX_HOST_BYTE_US;
+    uint32_t bound = sendMode == DMX_SEND_PERIODIC ? 1000000 / 40 + frameUs : 2 * frameUs;
+    int failed = error != ESP_OK || result.patternsReceived != result.patterns || result.framesDropped != 0 || result.framesReceived == 0
+                 || result.slotErrors != 0 || result.lineErrors != 0 || result.testPacketsReceived != result.testPacketsSent
+                 || result.testPacketErrors != 0 || atomic_load(&handled) != result.testPacketsReceived || result.latencyP50Us > bound;
+
+    printf("%s,%u,%u,%u,%u,%u,%u,%u,%.2e,%u,%u,%u,%u,%u,%u,%u,%s\n", name, result.patterns, result.patternsReceived, result.framesSent,
+           result.framesReceived, result.framesDropped, result.slotsChecked, result.slotErrors, result.slotErrorRate,
+           result.testPacketsSent, result.testPacketsReceived, result.latencyMinUs, result.latencyP50Us, result.latencyP90Us,
+           result.latencyP99Us, result.latencyMaxUs, failed ? "FAIL" : "ok");
+    return failed;
+}
+
+int main(){
+    static const scenario scenarios[] = {
+        {"periodic_512", DMX_SEND_PERIODIC, 40, 512},
+        {"periodic_512", DMX_SEND_PERIODIC, 44, 512},
+        {"periodic_24", DMX_SEND_PERIODIC, 400, 24},
+        {"on_change_512", DMX_SEND_ON_CHANGE, 10, 512},
+    };
+    int failed = 0;
+
+    dmxHostSetTimeScale(TIME_SCALE);
+    printf("scenario,slots,target_hz,frames_sent,frames_received,send_hz,receive_hz,avg_interval_us,overruns,torn_frames,errors,interrupts,result\n");
+    for(size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++){
+        failed |= run(&scenarios[i]);
+    }
+
+    printf("\nself_test,patterns,patterns_received,frames_sent,frames_received,frames_dropped,slots_checked,slot_errors,"
+           "slot_error_rate,test_packets_sent,test_packets_received,latency_min_us,latency_p50_us,latency_p90_us,latency_p99_us,"
+           "latency_max_us,result\n");
+    failed |= selfTest("periodic_512", DMX_SEND_PERIODIC);
+    failed |= selfTest("on_change_512", DMX_SEND_ON_CHANGE);
+    return failed;
+}
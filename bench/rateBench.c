@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Checks the rate table of the README on the Linux port: for every slot count and break timing of the table a
+// sending instance runs at the highest refresh rate (830Hz requested, clamped to the wire time) into a receiving
+// one. Reports the wire time limit (dmxFramePeriodUs()) and the rate the scheduler reached, a row fails below
+// MIN_SHARE of the limit, if the receiver doesn't get the frames or if a frame counted as a txDoneTimeout.
+// The simulated tasks wake tens of µs late (several timer wakeups per frame), so short frames reach less of
+// their limit on a host than on the chip.
+
+#include "dmx4esp.h"
+#include "dmxHost.h"
+#include "dmxFrame.h"
+#include "esp_timer.h"
+#include <stdio.h>
+
+#define RUN_US 500000
+#define TIME_SCALE 0.25 // the bus runs at quarter speed, so the wakeup latency of the host adds little to the frame time
+#define MIN_SHARE 0.8
+
+typedef struct row {
+    uint16_t slots;
+    uint32_t breakUs;
+    uint32_t markUs;
+} row;
+
+static int run(const row *r){
+    dmx_handle_t receiver;
+    dmx_handle_t sender;
+    dmxConfig rxConfig = {.port = UART_NUM_2, .pinout = {GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_4}, .send = false};
+    dmxConfig txConfig = {.port = UART_NUM_1, .pinout = {GPIO_NUM_18, GPIO_NUM_19, GPIO_NUM_5}, .send = true,
+                          .refreshRate = DMX_MAX_SHORT_FRAME_RATE, .slotCount = r->slots, .breakUs = r->breakUs, .markUs = r->markUs};
+
+    dmxHostConnect(UART_NUM_1, UART_NUM_2);
+    if(dmxCreate(&rxConfig, &receiver) != ESP_OK || dmxCreate(&txConfig, &sender) != ESP_OK){
+        return 1;
+    }
+    //settle, then count
+    dmxHostSleepUntil(esp_timer_get_time() + 50000);
+    dmxStats txBefore;
+    dmxStats rxBefore;
+    dmxGetStats(sender, &txBefore);
+    dmxGetStats(receiver, &rxBefore);
+    int64_t start = esp_timer_get_time();
+    dmxHostSleepUntil(start + RUN_US);
+
+    dmxStats tx;
+    dmxStats rx;
+    dmxRefreshStats refresh;
+    dmxGetStats(sender, &tx);
+    int64_t elapsed = esp_timer_get_time() - start;
+    dmxGetTransmitStats(sender, &refresh);
+    dmxDelete(sender);
+    dmxHostSleepUntil(dmxHostWireIdleAt(UART_NUM_2) + 1000); //frame on the wire arrives
+    dmxGetStats(receiver, &rx);
+    dmxDelete(receiver);
+
+    uint32_t period = dmxFramePeriodUs(DMX_MAX_SHORT_FRAME_RATE, r->slots, r->breakUs, r->markUs);
+    uint32_t sent = tx.framesSent - txBefore.framesSent;
+    uint32_t received = rx.framesReceived - rxBefore.framesReceived;
+    uint32_t errors = rx.frameErrors + rx.parityErrors + rx.fifoOverflows + rx.longFrames;
+    double limit = 1e6 / period;
+    double rate = sent * 1e6 / elapsed;
+    uint32_t timeouts = tx.txDoneTimeouts - txBefore.txDoneTimeouts;
+    int failed = rate < limit * MIN_SHARE || received + 2 < sent || errors != 0 || timeouts != 0;
+
+    printf("%u,%u,%u,%u,%.1f,%.1f,%.1f,%u,%u,%u,%u,%s\n", r->slots, r->breakUs, r->markUs, period, limit, rate, rate * 100 / limit,
+           refresh.overruns, timeouts, sent, received, failed ? "FAIL" : "ok");
+    return failed;
+}
+
+int main(){
+    static const uint16_t slotCounts[] = {24, 32, 48, 64, 96, 128, 192, 256, 384, 512};
+    static const uint32_t timings[][2] = {{250, 20}, {92, 12}};
+    int failed = 0;
+
+    dmxHostSetTimeScale(TIME_SCALE);
+    printf("slots,break_us,mab_us,period_us,limit_hz,achieved_hz,achieved_pct,overruns,tx_done_timeouts,frames_sent,frames_received,result\n");
+    for(size_t t = 0; t < 2; t++){
+        for(size_t i = 0; i < sizeof(slotCounts) / sizeof(slotCounts[0]); i++){
+            row r = {slotCounts[i], timings[t][0], timings[t][1]};
+            failed |= run(&r);
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Stresses the triple buffered receive frames: a writer thread publishes frames as fast as
+// possible (every slot of frame n holds n & 0xFF), reader threads acquire the latest frame and
+// check that all of its slots match and that sequence numbers never go backwards.
+// Any torn frame is reported and makes the program exit with an error.
+
+#include "dmxRxBuffer.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define PUBLISHED_FRAMES 2000000
+#define MAX_READERS 4
+
+static dmxRxBuffer buffer;
+static atomic_bool running;
+
+typedef struct readerResult {
+    unsigned long acquires;
+    unsigned long torn;
+    unsigned long backwards;
+    double seconds;
+} readerResult;
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//models the decoder in the UART interrupt
+static void* writerThread(void *parameters){
+    uint8_t *packet = dmxRxBufferWritePacket(&buffer);
+
+    for(uint32_t frame = 1; frame <= PUBLISHED_FRAMES; frame++){
+        packet[0] = 0x00;
+        memset(&packet[1], (uint8_t) (buffer.sequence + 1), 512);
+        packet = dmxRxBufferPublish(&buffer, 513, frame);
+    }
+    atomic_store(&running, false);
+    return NULL;
+}
+
+static void* readerThread(void *parameters){
+    readerResult *result = parameters;
+    uint32_t lastSequence = 0;
+
+    double start = nowSeconds();
+    while(atomic_load(&running)){
+        const dmxRxFrame *frame = dmxRxBufferAcquire(&buffer);
+        result->acquires++;
+
+        if(frame->sequence < lastSequence){
+            result->backwards++;
+        }
+        lastSequence = frame->sequence;
+
+        uint8_t expected = (uint8_t) frame->sequence;
+        for(int slot = 1; slot <= 512; slot++){
+            if(frame->packet[slot] != expected){
+                result->torn++;
+                break;
+            }
+        }
+        dmxRxBufferRelease(&buffer, frame);
+    }
+    result->seconds = nowSeconds() - start;
+    return NULL;
+}
+
+int main(){
+    int failed = 0;
+
+    printf("readers,frames_published,frames_dropped,acquires,torn_frames,sequence_backwards,ns_per_acquire_and_check\n");
+    for(int readers = 1; readers <= MAX_READERS; readers++){
+        pthread_t writer;
+        pthread_t readerThreads[MAX_READERS];
+        readerResult results[MAX_READERS];
+
+        dmxRxBufferInit(&buffer);
+        memset(results, 0, sizeof(results));
+        atomic_store(&running, true);
+
+        for(int i = 0; i < readers; i++){
+            pthread_create(&readerThreads[i], NULL, readerThread, &results[i]);
+        }
+        pthread_create(&writer, NULL, writerThread, NULL);
+
+        pthread_join(writer, NULL);
+        readerResult total = {0};
+        for(int i = 0; i < readers; i++){
+            pthread_join(readerThreads[i], NULL);
+            total.acquires += results[i].acquires;
+            total.torn += results[i].torn;
+            total.backwards += results[i].backwards;
+            total.seconds += results[i].seconds;
+        }
+
+        printf("%d,%u,%u,%lu,%lu,%lu,%.0f\n", readers, buffer.sequence, buffer.dropped, total.acquires, total.torn, total.backwards,
+               total.acquires > 0 ? total.seconds * 1e9 / total.acquires : 0.0);
+        if(total.torn != 0 || total.backwards != 0){
+            failed = 1;
+        }
+    }
+
+    return failed;
+}
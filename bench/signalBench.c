@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Runs the loss of signal monitor on a virtual clock: frames at 44Hz, a dropout, then frames again.
+// Every policy is checked for the lost / restored events and the output levels (hold, fade, blackout),
+// and the fade scaling against an exact division. Afterwards the cost of one fade step is measured.
+
+#include "dmxSignal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TICK_US 20000
+#define FRAME_US 22727 // 44Hz
+#define TIMEOUT_MS 1000
+#define HOLD_MS 500
+#define FADE_MS 2000
+#define ITERATIONS 200000
+
+typedef struct timeline {
+    int64_t lostAt; // µs, 0 if never lost
+    int64_t restoredAt;
+    int64_t blackAt; // first output with level 0
+    uint32_t outputs;
+    int increasing; // level went up while lost
+} timeline;
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//frames until 2s, dropout until 6s, frames until 8s
+static timeline simulate(dmxLossPolicy policy){
+    dmxSignalMonitor monitor;
+    timeline result = {0};
+    uint8_t lastLevel = 255;
+    int64_t nextFrame = FRAME_US;
+
+    dmxSignalInit(&monitor, policy, TIMEOUT_MS, HOLD_MS, FADE_MS);
+    for(int64_t now = TICK_US; now <= 8000000; now += TICK_US){
+        while(nextFrame <= now){
+            if(nextFrame < 2000000 || nextFrame >= 6000000){
+                dmxSignalFrame(&monitor, nextFrame);
+            }
+            nextFrame += FRAME_US;
+        }
+
+        uint32_t events = dmxSignalTick(&monitor, now);
+        if(events & DMX_SIGNAL_EVENT_LOST){
+            result.lostAt = now;
+        }
+        if(events & DMX_SIGNAL_EVENT_RESTORED){
+            result.restoredAt = now;
+        }
+        if(events & DMX_SIGNAL_EVENT_OUTPUT){
+            result.outputs++;
+            if(monitor.level > lastLevel){
+                result.increasing = 1;
+            }
+            if(monitor.level == 0 && result.blackAt == 0){
+                result.blackAt = now;
+            }
+            lastLevel = monitor.level;
+        }
+    }
+    return result;
+}
+
+static int checkScale(){
+    uint8_t packet[513];
+    uint8_t output[513];
+
+    for(int slot = 0; slot < 513; slot++){
+        packet[slot] = slot;
+    }
+    for(int level = 0; level <= 255; level++){
+        dmxSignalScale(packet, output, 513, level);
+        for(int slot = 1; slot < 513; slot++){
+            if(output[slot] != packet[slot] * level / 255){
+                fprintf(stderr, "scale mismatch: value %d, level %d\n", packet[slot], level);
+                return 1;
+            }
+        }
+        if(output[0] != packet[0]){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(){
+    static const char *policyNames[] = {"hold", "fade", "blackout"};
+    int failed = checkScale();
+
+    printf("policy,lost_ms,restored_ms,black_ms,outputs,ns_per_fade_step\n");
+    for(dmxLossPolicy policy = DMX_LOSS_HOLD; policy <= DMX_LOSS_BLACKOUT; policy++){
+        timeline result = simulate(policy);
+
+        //last frame before 2s, lost one timeout later (within a tick), restored with the first tick after 6s
+        int lostOk = result.lostAt >= 2000000 - FRAME_US + TIMEOUT_MS * 1000 && result.lostAt <= 2000000 + TIMEOUT_MS * 1000 + TICK_US;
+        int restoredOk = result.restoredAt >= 6000000 && result.restoredAt <= 6000000 + FRAME_US + TICK_US;
+        int outputOk = 0;
+        switch(policy){
+            case DMX_LOSS_HOLD:
+                outputOk = result.outputs == 0;
+                break;
+            case DMX_LOSS_FADE:
+                outputOk = !result.increasing && result.blackAt >= result.lostAt + (HOLD_MS + FADE_MS) * 1000
+                           && result.blackAt <= result.lostAt + (HOLD_MS + FADE_MS) * 1000 + TICK_US && result.outputs > 50;
+                break;
+            case DMX_LOSS_BLACKOUT:
+                outputOk = result.outputs == 1 && result.blackAt == result.lostAt;
+                break;
+        }
+        if(!lostOk || !restoredOk || !outputOk){
+            failed = 1;
+        }
+
+        //one fade step: tick plus scaling a full frame
+        static uint8_t packet[513];
+        static uint8_t output[513];
+        dmxSignalMonitor monitor;
+        dmxSignalInit(&monitor, policy, TIMEOUT_MS, 0, FADE_MS);
+        dmxSignalFrame(&monitor, 1);
+        double start = nowSeconds();
+        for(int i = 0; i < ITERATIONS; i++){
+            dmxSignalTick(&monitor, 1 + TIMEOUT_MS * 1000 + (int64_t) i * 10);
+            dmxSignalScale(packet, output, 513, monitor.level);
+        }
+        double elapsed = nowSeconds() - start;
+
+        printf("%s,%lld,%lld,%lld,%u,%.0f\n", policyNames[policy], (long long) result.lostAt / 1000, (long long) result.restoredAt / 1000,
+               (long long) result.blackAt / 1000, result.outputs, elapsed * 1e9 / ITERATIONS);
+    }
+
+    return failed;
+}
@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Compares the lock-free sendAddress() path (dmxTxFrameSetSlot) against the previous
+// mutex-per-slot path. On the host the FreeRTOS mutex is modelled with a pthread mutex.
+// A background thread snapshots the frame like the send task does, so both paths run
+// under the same contention.
+
+#include "dmxFrame.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+#define WRITES_PER_THREAD 2000000
+
+static dmxTxFrame frame;
+static uint8_t mutexFrame[DMX_MAX_SLOTS];
+static pthread_mutex_t frameMutex = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool running;
+
+typedef enum {PATH_MUTEX, PATH_LOCK_FREE} writePath;
+
+typedef struct producerArgs {
+    writePath path;
+    uint16_t firstSlot;
+} producerArgs;
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//models the send task: take a snapshot roughly every frame boundary
+static void* senderThread(void *parameters){
+    writePath path = *(writePath*) parameters;
+    uint8_t packet[DMX_MAX_SLOTS];
+    uint32_t lastChangeSeq = 0;
+
+    while(atomic_load(&running)){
+        if(path == PATH_MUTEX){
+            pthread_mutex_lock(&frameMutex);
+            memcpy(packet, mutexFrame, DMX_MAX_SLOTS);
+            pthread_mutex_unlock(&frameMutex);
+        } else{
+            dmxTxFrameSnapshot(&frame, packet, &lastChangeSeq);
+        }
+        struct timespec pause = {0, 50000}; //sped up frame period to increase contention
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+static void* producerThread(void *parameters){
+    producerArgs *args = parameters;
+
+    for(uint32_t i = 0; i < WRITES_PER_THREAD; i++){
+        uint16_t slot = (args->firstSlot + i) % DMX_MAX_SLOTS;
+        if(args->path == PATH_MUTEX){
+            pthread_mutex_lock(&frameMutex);
+            mutexFrame[slot] = (uint8_t) i;
+            pthread_mutex_unlock(&frameMutex);
+        } else{
+            dmxTxFrameSetSlot(&frame, slot, (uint8_t) i);
+        }
+    }
+    return NULL;
+}
+
+static double runBenchmark(writePath path, int producers){
+    pthread_t sender;
+    pthread_t threads[producers];
+    producerArgs args[producers];
+
+    dmxTxFrameInit(&frame);
+    atomic_store(&running, true);
+    pthread_create(&sender, NULL, senderThread, &path);
+
+    double start = nowSeconds();
+    for(int i = 0; i < producers; i++){
+        args[i].path = path;
+        args[i].firstSlot = i * (DMX_MAX_SLOTS / producers);
+        pthread_create(&threads[i], NULL, producerThread, &args[i]);
+    }
+    for(int i = 0; i < producers; i++){
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = nowSeconds() - start;
+
+    atomic_store(&running, false);
+    pthread_join(sender, NULL);
+
+    return elapsed * 1e9 / ((double) WRITES_PER_THREAD * producers); //ns per write
+}
+
+int main(int argc, char **argv){
+    int maxProducers = argc > 1 ? atoi(argv[1]) : 4;
+
+    printf("producers,mutex_ns_per_write,lockfree_ns_per_write,speedup\n");
+    for(int producers = 1; producers <= maxProducers; producers *= 2){
+        double mutexNs = runBenchmark(PATH_MUTEX, producers);
+        double lockFreeNs = runBenchmark(PATH_LOCK_FREE, producers);
+        printf("%d,%.2f,%.2f,%.2f\n", producers, mutexNs, lockFreeNs, mutexNs / lockFreeNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Records into a trace ring from one thread while another one keeps reading it, every read has to be
+// a gapless, untorn sequence of events. Afterwards the cost of one record on the hot path is measured.
+// With --sample a synthetic send / receive trace is printed in the format of dmxTracePrint():
+//   ./build-bench/traceBench --sample | python3 bench/traceHistogram.py
+
+#include "dmxTrace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RECORDS 20000000
+#define CYCLES_PER_US 240
+
+static dmxTraceRing ring;
+static atomic_int writing;
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//cycles carries the sequence number, arg its low bits and event a check value
+static void* writer(void *parameters){
+    (void) parameters;
+    for(uint32_t i = 0; i < RECORDS; i++){
+        dmxTraceRecord(&ring, i, (dmxTraceEvent) (i % DMX_TRACE_EVENT_COUNT), (uint16_t) i);
+    }
+    atomic_store(&writing, 0);
+    return NULL;
+}
+
+static int checkConcurrentReads(uint32_t *reads, uint32_t *entriesRead){
+    static dmxTraceEntry entries[DMX_TRACE_ENTRIES];
+    pthread_t thread;
+    int failed = 0;
+
+    dmxTraceInit(&ring);
+    atomic_store(&writing, 1);
+    pthread_create(&thread, NULL, writer, NULL);
+    while(atomic_load(&writing)){
+        size_t count = dmxTraceRead(&ring, entries, DMX_TRACE_ENTRIES);
+        for(size_t i = 0; i < count; i++){
+            const dmxTraceEntry *entry = &entries[i];
+            if(entry->arg != (uint16_t) entry->cycles || entry->event != entry->cycles % DMX_TRACE_EVENT_COUNT
+               || (i > 0 && entry->cycles != entries[i - 1].cycles + 1)){
+                failed = 1;
+                break;
+            }
+        }
+        (*reads)++;
+        *entriesRead += count;
+    }
+    pthread_join(thread, NULL);
+
+    //the final read returns the newest events, the oldest slot counts as being rewritten
+    size_t count = dmxTraceRead(&ring, entries, DMX_TRACE_ENTRIES);
+    if(count != DMX_TRACE_ENTRIES - 1 || entries[count - 1].cycles != RECORDS - 1){
+        failed = 1;
+    }
+    return failed;
+}
+
+//stage durations in µs, roughly what a 44Hz sender and a receiver look like
+static void printSample(){
+    uint32_t cycles = 0;
+    srand(1);
+
+    printf("# dmx4esp trace port=2 cycles_per_us=%d\n", CYCLES_PER_US);
+    printf("cycles,event,arg\n");
+    for(int frame = 0; frame < 400; frame++){
+        static const struct {dmxTraceEvent event; uint32_t us; uint32_t spread; uint16_t arg;} stages[] = {
+            {DMX_TRACE_TX_WAKE, 20000, 600, 1}, {DMX_TRACE_TX_DRAINED, 4, 3, 0}, {DMX_TRACE_TX_SNAPSHOT, 3, 2, 1},
+            {DMX_TRACE_TX_BREAK, 1, 1, 0}, {DMX_TRACE_TX_MAB, 250, 40, 0}, {DMX_TRACE_TX_WRITE, 20, 30, 0},
+            {DMX_TRACE_TX_WRITTEN, 60, 20, 513}, {DMX_TRACE_TX_SLEEP, 2, 1, 0}
+        };
+        for(size_t i = 0; i < sizeof(stages) / sizeof(stages[0]); i++){
+            cycles += (stages[i].us + rand() % stages[i].spread) * CYCLES_PER_US;
+            printf("%u,%s,%u\n", cycles, dmxTraceEventName(stages[i].event), stages[i].arg);
+        }
+    }
+
+    printf("# dmx4esp trace port=1 cycles_per_us=%d\n", CYCLES_PER_US);
+    printf("cycles,event,arg\n");
+    for(int frame = 0; frame < 400; frame++){
+        for(int chunk = 0; chunk < 8; chunk++){
+            cycles += (2800 + rand() % 50) * CYCLES_PER_US;
+            printf("%u,rx_enter,0\n", cycles);
+            cycles += (8 + rand() % 4) * CYCLES_PER_US;
+            printf("%u,%s,64\n", cycles, chunk == 7 ? "rx_break" : "rx_bytes");
+            if(chunk == 7){
+                cycles += (6 + rand() % 20) * CYCLES_PER_US;
+                printf("%u,rx_publish,513\n", cycles);
+            }
+            cycles += 2 * CYCLES_PER_US;
+            printf("%u,rx_exit,0\n", cycles);
+        }
+    }
+}
+
+int main(int argc, char **argv){
+    if(argc > 1 && strcmp(argv[1], "--sample") == 0){
+        printSample();
+        return 0;
+    }
+
+    uint32_t reads = 0;
+    uint32_t entriesRead = 0;
+    int failed = checkConcurrentReads(&reads, &entriesRead);
+
+    dmxTraceInit(&ring);
+    double start = nowSeconds();
+    for(uint32_t i = 0; i < RECORDS; i++){
+        dmxTraceRecord(&ring, i, DMX_TRACE_TX_WRITE, 0);
+    }
+    double elapsed = nowSeconds() - start;
+
+    printf("records,concurrent_reads,avg_entries_per_read,ns_per_record,result\n");
+    printf("%u,%u,%.0f,%.2f,%s\n", RECORDS, reads, reads > 0 ? (double) entriesRead / reads : 0.0, elapsed * 1e9 / RECORDS, failed ? "fail" : "ok");
+    return failed;
+}
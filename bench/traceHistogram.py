@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+#
+# SPDX-License-Identifier: MIT
+
+"""Per-stage latency histograms from a dmx4esp trace.
+
+Reads the CSV printed by dmxTracePrint() (other lines of a serial log are skipped) or, with --binary,
+the raw dmxTraceEntry array returned by dmxTraceDump(). The time between two consecutive events is
+the latency of the stage in between, e.g. tx_break -> tx_mab is the break, tx_mab -> tx_write the
+mark after break. Every stage gets count / min / p50 / p99 / max and a log2 histogram in µs.
+
+    python3 bench/traceHistogram.py monitor.log
+    python3 bench/traceHistogram.py --binary trace.bin --cycles-per-us 240
+    python3 bench/traceHistogram.py --csv monitor.log > stages.csv
+"""
+
+import argparse
+import re
+import struct
+import sys
+from collections import defaultdict
+
+# same order as dmxTraceEvent in src/dmxTrace.h
+EVENTS = ["tx_sleep", "tx_wake", "tx_drained", "tx_overrun", "tx_snapshot", "tx_break", "tx_mab", "tx_write", "tx_written",
+          "rx_enter", "rx_break", "rx_bytes", "rx_error", "rx_publish", "rx_exit"]
+
+HEADER = re.compile(r"# dmx4esp trace port=(\d+) cycles_per_us=(\d+)")
+ENTRY = re.compile(r"^(\d+),([a-z_]+),(\d+)$")
+BUCKETS = 16  # [0] < 1µs, [n] < 2^n µs
+
+
+def read_csv(lines, default_cycles_per_us):
+    """Yields (port, cycles per µs, entries) for every trace in the log."""
+    port, cycles_per_us, entries = None, default_cycles_per_us, []
+    for line in lines:
+        line = line.strip()
+        header = HEADER.search(line)
+        if header:
+            if entries:
+                yield port, cycles_per_us, entries
+            port, cycles_per_us, entries = int(header.group(1)), int(header.group(2)), []
+            continue
+        entry = ENTRY.match(line)
+        if entry:
+            entries.append((int(entry.group(1)), entry.group(2), int(entry.group(3))))
+    if entries:
+        yield port, cycles_per_us, entries
+
+
+def read_binary(data, cycles_per_us):
+    entries = []
+    for cycles, arg, event, _ in struct.iter_unpack("<IHBB", data):
+        entries.append((cycles, EVENTS[event] if event < len(EVENTS) else "unknown", arg))
+    yield None, cycles_per_us, entries
+
+
+def stages(entries, cycles_per_us):
+    """Groups the time between consecutive events by stage (previous -> next event), in µs."""
+    result = defaultdict(list)
+    for (start, first, _), (end, second, _) in zip(entries, entries[1:]):
+        result[f"{first}->{second}"].append(((end - start) & 0xFFFFFFFF) / cycles_per_us)
+    return result
+
+
+def percentile(values, fraction):
+    return values[min(len(values) - 1, int(fraction * len(values)))]
+
+
+def histogram(values):
+    buckets = [0] * BUCKETS
+    for value in values:
+        bucket = 0
+        while bucket < BUCKETS - 1 and value >= (1 << bucket):
+            bucket += 1
+        buckets[bucket] += 1
+    return buckets
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("trace", nargs="?", help="log / dump file, stdin if omitted")
+    parser.add_argument("--binary", action="store_true", help="raw dmxTraceEntry array from dmxTraceDump()")
+    parser.add_argument("--cycles-per-us", type=int, default=240, help="CPU clock if the trace has no header (default 240)")
+    parser.add_argument("--csv", action="store_true", help="machine readable output")
+    args = parser.parse_args()
+
+    if args.binary:
+        with open(args.trace, "rb") if args.trace else sys.stdin.buffer as source:
+            traces = list(read_binary(source.read(), args.cycles_per_us))
+    else:
+        with open(args.trace) if args.trace else sys.stdin as source:
+            traces = list(read_csv(source, args.cycles_per_us))
+
+    if args.csv:
+        print("port,stage,count,min_us,p50_us,p99_us,max_us," + ",".join(f"lt_{1 << n}us" for n in range(BUCKETS - 1))
+              + f",ge_{1 << (BUCKETS - 2)}us")
+    for port, cycles_per_us, entries in traces:
+        if not args.csv:
+            print(f"port {port if port is not None else '?'}: {len(entries)} events, {cycles_per_us} cycles/µs")
+        for stage, values in sorted(stages(entries, cycles_per_us).items()):
+            values.sort()
+            summary = (len(values), values[0], percentile(values, 0.5), percentile(values, 0.99), values[-1])
+            buckets = histogram(values)
+            if args.csv:
+                print(f"{port},{stage},{summary[0]},{summary[1]:.2f},{summary[2]:.2f},{summary[3]:.2f},{summary[4]:.2f},"
+                      + ",".join(str(count) for count in buckets))
+                continue
+            print(f"  {stage:<26} n={summary[0]:<6} min={summary[1]:.1f} p50={summary[2]:.1f} p99={summary[3]:.1f} max={summary[4]:.1f} µs")
+            peak = max(buckets)
+            for n, count in enumerate(buckets):
+                if count:
+                    label = f"< {1 << n} µs" if n < BUCKETS - 1 else f">= {1 << (n - 1)} µs"
+                    print(f"    {label:>12} {count:>6} {'#' * max(1, 40 * count // peak)}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// Compares the bit-parallel frame encoder (8x8 bit-matrix transpose) against the scalar
+// one-bit-at-a-time reference. Every universe count and a few slot counts are checked
+// for bit-exact output first, the benchmark only runs if all of them match.
+
+#include "dmxParallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAMES 200
+
+static uint8_t packets[DMX_PARALLEL_MAX_UNIVERSES][513];
+static const uint8_t *packetPointers[DMX_PARALLEL_MAX_UNIVERSES];
+
+static double nowSeconds(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void randomizePackets(){
+    for(int universe = 0; universe < DMX_PARALLEL_MAX_UNIVERSES; universe++){
+        packets[universe][0] = 0x00; //start code
+        for(int slot = 1; slot < 513; slot++){
+            packets[universe][slot] = rand();
+        }
+        packetPointers[universe] = packets[universe];
+    }
+}
+
+static int checkBitExact(uint8_t *reference, uint8_t *optimized){
+    const uint16_t slotCounts[] = {1, 24, 100, 512};
+
+    for(uint8_t universes = 1; universes <= DMX_PARALLEL_MAX_UNIVERSES; universes++){
+        for(size_t i = 0; i < sizeof(slotCounts) / sizeof(slotCounts[0]); i++){
+            size_t length = dmxParallelFrameSamples(slotCounts[i]) * dmxParallelSampleBytes(universes);
+            memset(optimized, 0x5A, length); //make sure every byte gets written
+
+            size_t referenceLength = dmxParallelEncodeFrameScalar(packetPointers, universes, slotCounts[i], reference);
+            size_t optimizedLength = dmxParallelEncodeFrame(packetPointers, universes, slotCounts[i], optimized);
+
+            if(referenceLength != length || optimizedLength != length || memcmp(reference, optimized, length) != 0){
+                fprintf(stderr, "mismatch: %u universes, %u slots\n", universes, slotCounts[i]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+typedef size_t (*encodeFunction)(const uint8_t *const packets[], uint8_t universes, uint16_t slotCount, uint8_t *samples);
+
+static double benchmark(encodeFunction encode, uint8_t universes, uint8_t *samples){
+    volatile uint8_t sink = 0;
+    double start = nowSeconds();
+    for(int frame = 0; frame < FRAMES; frame++){
+        packets[frame % universes][1 + frame % 512] ^= 1; //defeat caching of identical input
+        encode(packetPointers, universes, 512, samples);
+        sink ^= samples[frame];
+    }
+    (void) sink;
+    return (nowSeconds() - start) * 1e6 / FRAMES;
+}
+
+int main(){
+    size_t maxLength = dmxParallelFrameSamples(512) * dmxParallelSampleBytes(DMX_PARALLEL_MAX_UNIVERSES);
+    uint8_t *reference = malloc(maxLength);
+    uint8_t *optimized = malloc(maxLength);
+    if(reference == NULL || optimized == NULL){
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    srand(1);
+    randomizePackets();
+    if(checkBitExact(reference, optimized) != 0){
+        return 1;
+    }
+
+    printf("universes,frame_bytes,scalar_us_per_frame,transpose_us_per_frame,speedup\n");
+    const uint8_t universeCounts[] = {1, 4, 8, 12, 16};
+    for(size_t i = 0; i < sizeof(universeCounts) / sizeof(universeCounts[0]); i++){
+        uint8_t universes = universeCounts[i];
+        double scalarUs = benchmark(dmxParallelEncodeFrameScalar, universes, reference);
+        double transposeUs = benchmark(dmxParallelEncodeFrame, universes, optimized);
+        printf("%u,%zu,%.2f,%.2f,%.1f\n", universes, dmxParallelFrameSamples(512) * dmxParallelSampleBytes(universes), scalarUs, transposeUs, scalarUs / transposeUs);
+    }
+
+    free(reference);
+    free(optimized);
+    return 0;
+}
@@ -5,6 +5,13 @@
  */
 
 #include "dmx4esp.h"
+#include "dmxFrame.h"
+#include "dmxDecoder.h"
+#include "dmxRxBuffer.h"
+#include "dmxDiff.h"
+#include "dmxSignal.h"
+#include "dmxStartCode.h"
+#include "dmxTrace.h"
 #include <stdio.h>
 #include <inttypes.h>
 #include "freertos/FreeRTOS.h"
@@ -14,35 +21,251 @@
 #include "string.h"
 #include "driver/gpio.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_intr_alloc.h"
+#include "hal/uart_ll.h"
+#include "soc/uart_periph.h"
+#include "sdkconfig.h"
+#include <stdatomic.h>
+
+#if DMX_DMA_SUPPORTED
+#include "driver/uhci.h"
+#endif
 
 static const int RX_BUF_SIZE = 512;
 
-//Async DMX Handler for multithreading, I'm using a semaphore in order to prevent race conditions and avoid data corruption during transmission.
- static QueueHandle_t uart_queue; //stores the event queue handle
-static SemaphoreHandle_t sendDMXSemaphore; //semaphore in form of a Mutex
-static TaskHandle_t dmxOperationsTaskHandle; //keep track of running tasks
+//UART DMX Communication Protocol
+#define delayBreakMICROSEC 250 // default duration of the Break Signal (>88µs)
+#define delayMarkMICROSEC 20 // default duration of the Mark After Break Signal (>12µs)
+#define DMX_TX_DONE_MARGIN_US (2 * DMX_SLOT_US) //a frame still on the wire this long after its estimated end counts as a timeout
 
-//define pinout
-static gpio_num_t TXD_PIN = GPIO_NUM_NC;
-static gpio_num_t RXD_PIN = GPIO_NUM_NC;
-static gpio_num_t rxtxDIR_PIN = GPIO_NUM_NC;
-static const uart_port_t UART_PORT = UART_NUM_2; // we're using UART_NUM_2, UART_NUM_0 is connected to Serial UART Interface
+//notification bits of the send task
+#define DMX_NOTIFY_FRAME (1 << 0) //frame deadline reached
+#define DMX_NOTIFY_STEP (1 << 1) //mark after break / wait for the frame end elapsed
+#define DMX_NOTIFY_CHANGE (1 << 2) //new data committed (DMX_SEND_ON_CHANGE)
+#define DMX_NOTIFY_STOP (1 << 3) //dmxDelete(): stop using the timers and wait to be deleted
+#define DMX_NOTIFY_BREAK (1 << 4) //break ended by the break timer
 
-//UART DMX Communication Protocol
-#define delayBreakMICROSEC 250 // duration of the Break Signal (>88µs)
-#define delayMarkMICROSEC 20 // duration of the Mark After Break Signal (>12µs)
+//notification bit of a task running dmxSelfTest(), kept clear of the low bits applications use
+#define DMX_NOTIFY_SELF_TEST (1u << 31) //current pattern arrived
 
-//enums needed for internal dmx decoding
-DMXStatus dmxStatus = SEND;
+#define DMX_LATENCY_BUCKET_US 500 //width of the first latency histogram bucket
+
+#define DMX_LOAD_PROBE_GAP_CYCLES 200 //a probe loop iteration taking longer was interrupted or preempted
+
+//receive interrupt: drain the FIFO at 64 bytes (~2.8ms) or after 2 idle slot times, and on every break
+#define DMX_RX_FIFO_THRESHOLD 64
+#define DMX_RX_TIMEOUT_BITS 22
+#define DMX_RX_INTERRUPTS (UART_INTR_RXFIFO_FULL | UART_INTR_RXFIFO_TOUT | UART_INTR_BRK_DET | UART_INTR_FRAM_ERR | UART_INTR_PARITY_ERR | UART_INTR_RXFIFO_OVF)
+
+#define DMX_SIGNAL_TICK_US 20000 //loss of signal check & fade step (50Hz)
+
+//trace points, nothing is compiled in unless DMX_TRACE_ENABLED is set
+#if DMX_TRACE_ENABLED
+#define DMX_TRACE(dmx, event, arg) dmxTraceRecord(&(dmx)->trace, esp_cpu_get_cycle_count(), event, arg)
+#else
+#define DMX_TRACE(dmx, event, arg) ((void) 0)
+#endif
+
+#ifndef CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ 160
+#endif
+
+/**
+ * @brief One frame-received subscription, slot in the subscriber table of an instance.
+ */
+struct dmxSubscriber {
+    bool active;
+    dmxSubscribeConfig config; //firstAddress 0 -> every frame
+};
+
+/**
+ * @brief Alternate start code packet waiting to be sent, item of the alternate queue of an instance.
+ */
+struct dmxAlternateFrame {
+    uint16_t length; //bytes, start code included
+    uint8_t packet[513] __attribute__((aligned(4))); //[0] start code
+};
+
+/**
+ * @brief Handler of one alternate start code, slot in the handler table of an instance.
+ */
+struct dmxStartCodeEntry {
+    bool active;
+    uint8_t startCode;
+    dmxStartCodeHandler handler;
+    void *context;
+};
+
+/**
+ * @brief State of a running dmxSelfTest(), shared with the receive callback (guarded by lock).
+ */
+struct dmxSelfTestRun {
+    portMUX_TYPE lock; //the callback runs in the UART interrupt, or in the esp_timer task for frames of a lost signal
+    struct dmxInstance *sender;
+    TaskHandle_t task; //notified once the current pattern arrived
+    uint16_t slotCount; //of the sender
+    uint8_t number; //current pattern
+    bool locked; //the first pattern arrived, earlier frames still carry the sender's previous data
+    bool arrived; //current pattern arrived
+    int64_t commitUs; //time the current pattern was written
+    uint32_t *latencies; //one per pattern that arrived (µs)
+    uint32_t latencyCount;
+    uint32_t framesChecked;
+    uint32_t slotsChecked;
+    uint32_t slotErrors;
+    uint32_t sentFirst; //null frames sent / received when the first pattern arrived
+    uint32_t receivedFirst;
+    uint32_t sentLast; //... and when the last frame was checked
+    uint32_t receivedLast;
+};
+
+/**
+ * @brief State of one busy loop of dmxMeasureCpuLoad(), shared with the measuring task.
+ */
+struct dmxLoadProbe {
+    atomic_bool stop;
+    atomic_bool done;
+    uint64_t stolenCycles; //cycles the core spent outside the probe (interrupts, other tasks)
+    uint64_t totalCycles;
+};
+
+/**
+ * @brief State of one DMX universe (one UART port). Every instance runs its own task and timers.
+ */
+struct dmxInstance {
+    uart_port_t port;
+    dmxPinout pinout;
+    bool send;
+    DMXStatus status;
+    TaskHandle_t task; //send task of this instance
+    atomic_bool taskStopped; //the send task parked on DMX_NOTIFY_STOP, it doesn't touch the timers anymore
+
+    //send
+    SemaphoreHandle_t writeMutex; //only serializes full frame writers (never held while the UART is busy)
+    dmxTxFrame frame; //shared send frame, producers write it lock-free
+
+    //double buffered send packet owned by the send task: snapshot into the back buffer, transmit the front buffer
+    //[0] holds the start code, [1 - 512] the channels -> start code and slots go out in one write
+    //(word aligned in internal RAM, so the DMA transmit mode can stream the front buffer directly,
+    //rows are padded to 516 bytes so the second one starts on a word boundary too)
+    uint8_t packet[2][516] __attribute__((aligned(4)));
+    uint8_t *frontPacket; //frame on the wire
+    uint8_t *backPacket; //next frame
+    uint32_t sentChangeSeq; //change sequence of the frame in frontPacket
+    uint16_t slotCount; //slots per frame, shorter frames allow higher refresh rates
+    uint16_t wireLength; //bytes of the frame on the wire, start code included
+    int64_t transmitStartUs; //time the frame was handed to the UART, 0 before the first one
+    bool txDoneTimeoutCounted; //the frame on the wire was already counted in txDoneTimeouts
+
+    //alternate start code packets, interleaved between null start code frames by the send task
+    QueueHandle_t alternateQueue; //struct dmxAlternateFrame items
+    struct dmxAlternateFrame alternate; //packet on the wire, owned by the send task (DMA capable like the packets above)
+    uint8_t alternateInterleave; //null frames at least sent between two alternate frames
+    uint16_t minNullRate; //Hz, alternate frames are held back if the null frame rate would drop below, 0 -> no floor
+    uint8_t nullSinceAlternate;
+    int64_t lastNullStart;
+    dmxAlternateStats alternateStats; //only written by the send task
+    atomic_uint alternateQueueFull;
+
+    //frame scheduling, the send task is woken by a timer on every frame deadline
+    esp_timer_handle_t frameTimer;
+    esp_timer_handle_t stepTimer; //one-shot timer ending the mark after break and the wait for the frame end
+    esp_timer_handle_t breakTimer; //one-shot timer, its callback ends the break on the line itself
+    volatile int64_t breakEndUs; //time the break timer ended the break
+    uint32_t breakUs;
+    uint32_t markUs;
+    uint16_t refreshRate; //Hz, requested
+    uint32_t framePeriodUs; //break to break, limited by the frame length
+    dmxRefreshStats refresh; //achieved rate & jitter, only written by the send task
+    int64_t lastFrameStart;
+    uint32_t avgIntervalUs; //running average (1/16) of the frame interval
+    dmxSendMode sendMode;
+
+    //health counters, every field has a single writer (the send task or the UART interrupt) and is read without a lock
+    dmxStats stats;
+    int64_t lastReceived; //time the previous null start code frame was complete
 
-static uint8_t dmxPacket[512]; //send packet
-static uint8_t dmxReadOutput[512]; //received packet
-static uint16_t lastDmxReadAddress = 0;
+    //commit to first slot latency
+    atomic_uint firstChangeUs; //low 32 bits of the time the oldest unsent change was committed, 0 if none
+    dmxLatencyStats latency; //only written by the send task
+    uint64_t latencySumUs;
+
+    //transmit path, UART driver (copy into the driver's ring buffer) or DMA (zero-copy)
+    dmxTransmitMode transmitMode;
+#if DMX_DMA_SUPPORTED
+    uhci_controller_handle_t uhci;
+    volatile bool dmaBusy; //front buffer is still being streamed by the DMA
+#endif
+
+    //receive, decoded in the UART interrupt
+    intr_handle_t rxInterrupt;
+    portMUX_TYPE rxLock; //the interrupt and the signal timer both publish frames, one at a time
+    dmxDecoder decoder; //only used by the interrupt
+    dmxRxBuffer rxBuffer; //triple buffered frames, published by the interrupt, referenced by readers
+
+    //frame-received notifications, dispatched by the interrupt
+    portMUX_TYPE subscriberLock; //guards the table and dispatching, only held to copy the targets of a frame
+    uint32_t dispatching; //notifications copied but not sent yet, dmxUnsubscribe() waits for them
+    struct dmxSubscriber subscribers[DMX_MAX_SUBSCRIBERS];
+    BaseType_t rxYield; //a notified task has a higher priority than the interrupted one, only used by the interrupt
+
+    //alternate start code frames, decoded into their own packet and dispatched by the interrupt (guarded by rxLock)
+    uint8_t alternatePacket[513];
+    struct dmxStartCodeEntry startCodeHandlers[DMX_MAX_START_CODE_HANDLERS];
+    struct dmxStartCodeEntry alternateTarget; //handler of the frame just decoded, called outside rxLock (active -> pending)
+    const uint8_t *alternateFrame;
+    uint16_t alternateLength;
+    bool alternateDispatching; //a handler is running, dmxSetStartCodeHandler() waits for it
+    dmxStartCodeStats startCodeStats;
+
+    //loss of signal, checked by a periodic timer
+    esp_timer_handle_t signalTimer;
+    dmxSignalLossConfig signalLoss;
+    dmxSignalMonitor signal; //guarded by rxLock
+    uint8_t heldPacket[513] __attribute__((aligned(4))); //last valid frame, faded while the signal is lost
+    uint16_t heldLength;
+    const dmxRxFrame *published; //held by publishFrame() until the subscribers were notified outside rxLock (guarded by rxLock)
+    uint8_t fadePacket[513] __attribute__((aligned(4))); //heldPacket scaled to the output level, copied in under rxLock
+
+#if DMX_TRACE_ENABLED
+    dmxTraceRing trace; //written by the send task or the UART interrupt (under rxLock) only
+#endif
+};
+
+static _Atomic(dmx_handle_t) dmxInstances[UART_NUM_MAX]; //running instances by UART port, claimed by compare and swap
+
+//default instance used by setupDMX() / initDMX() / sendDMX() / readDMX() ...
+static dmx_handle_t defaultInstance = NULL;
+static dmxConfig defaultConfig = {
+    .port = UART_NUM_2, // we're using UART_NUM_2, UART_NUM_0 is connected to Serial UART Interface
+    .pinout = {.tx = GPIO_NUM_NC, .rx = GPIO_NUM_NC, .dir = GPIO_NUM_NC}
+};
+
+//enums needed for internal dmx decoding, mirrors the status of the default instance
+DMXStatus dmxStatus = SEND;
 
 /**
 * DMX
 */
 
+/**
+ * @brief Internal function to change the decoder status of an instance.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The instance.
+ * @param status The new status.
+ *
+ * @return void
+ */
+static void setStatus(dmx_handle_t dmx, DMXStatus status){
+    dmx->status = status;
+    if(dmx == defaultInstance){
+        dmxStatus = status;
+    }
+}
 
 /**
  * @brief Configures the GPIO pins for DMX communication.
@@ -56,341 +279,2584 @@ static uint16_t lastDmxReadAddress = 0;
  * @return void
  */
 void setupDMX(dmxPinout pinout){
-    TXD_PIN = pinout.tx;
-    RXD_PIN = pinout.rx;
-    rxtxDIR_PIN = pinout.dir;
+    defaultConfig.pinout = pinout;
 }
 
 /**
- * @brief Internal pipeline for sending current dmx data from internal uint8_t dmxPacket[512] once.
+ * @brief Internal function to pick up the latest shared frame at a frame boundary.
  *
  * @note This function is only expected to be used internally.
- * @param startCode Pointer to the start code, normally 0x00 for default control.
- *                                           Special cases covered in the README.
- * 
- * 
- * @return void
+ * @note Takes a consistent snapshot of the shared frame into the back buffer and swaps
+ *       front and back buffer pointers in O(1). Never takes a lock, if a full frame write
+ *       is in progress the previous frame is sent again.
+ * @param dmx The sending instance.
+ *
+ * @return commit time (low 32 bits, µs) of the oldest change in the new frame, 0 if the frame didn't change
  */
-static void sendDMXPipeline(uint8_t *startCode){
-    //UART communication
-    uart_wait_tx_done(UART_PORT, 1000); // wait 1000 ticks until empty
-    //Reset or Break > 88µs
-    uart_set_line_inverse(UART_PORT, UART_SIGNAL_TXD_INV); //create a break signal by inversing TXD signal
-    esp_rom_delay_us(delayBreakMICROSEC);
-    uart_set_line_inverse(UART_PORT, 0); //stopping break signal by flipping signal back to normal
-    //Mark > 12µs
-    esp_rom_delay_us(delayMarkMICROSEC); //Mark signal after Break
+static uint32_t swapDMXPackets(dmx_handle_t dmx){
+    //producers write before they stamp, so every stamped change is part of the snapshot
+    uint32_t changeUs = atomic_exchange_explicit(&dmx->firstChangeUs, 0, memory_order_acquire);
 
-    //Start Code
-    uart_write_bytes(UART_PORT, (const char*) startCode, 1); //mark start code
-
-    xSemaphoreTake(sendDMXSemaphore, portMAX_DELAY);
+    if(dmxTxFrameSnapshot(&dmx->frame, &dmx->backPacket[1], &dmx->sentChangeSeq)){
+        uint8_t *sentPacket = dmx->frontPacket;
+        dmx->frontPacket = dmx->backPacket;
+        dmx->backPacket = sentPacket;
+        return changeUs;
+    }
 
-    //DMX PACKET
-    uart_write_bytes(UART_PORT, (const char*) dmxPacket, 512);
+    if(changeUs != 0){
+        uint32_t none = 0;
+        atomic_compare_exchange_strong(&dmx->firstChangeUs, &none, changeUs); //not sent yet, keep it for the next frame
+    }
+    return 0;
+}
 
-    xSemaphoreGive(sendDMXSemaphore);
+/**
+ * @brief Internal function to record the latency from a commit to its first slot on the wire.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The sending instance.
+ * @param latencyUs Time from the commit to the first slot in µs.
+ *
+ * @return void
+ */
+static void recordLatency(dmx_handle_t dmx, uint32_t latencyUs){
+    dmxLatencyStats *latency = &dmx->latency;
 
-    uart_wait_tx_done(UART_PORT, 1000);
+    if(latency->samples == 0 || latencyUs < latency->minUs){
+        latency->minUs = latencyUs;
+    }
+    if(latencyUs > latency->maxUs){
+        latency->maxUs = latencyUs;
+    }
+    latency->samples++;
+    dmx->latencySumUs += latencyUs;
+    latency->avgUs = dmx->latencySumUs / latency->samples;
 
-    vTaskDelay(10 / portTICK_PERIOD_MS); //sleep 10ms
+    int bucket = 0;
+    while(bucket < DMX_LATENCY_BUCKETS - 1 && latencyUs >= ((uint32_t) DMX_LATENCY_BUCKET_US << bucket)){
+        bucket++;
+    }
+    latency->histogram[bucket]++;
 }
 
 /**
- * @brief Internal loop to send dmx continuously.
+ * @brief Internal function to stamp the commit time of a change and wake the send task in DMX_SEND_ON_CHANGE.
  *
  * @note This function is only expected to be used internally.
- * 
+ * @note Called after the data was written. Only the oldest unsent change keeps its stamp.
+ * @param dmx The sending instance.
+ *
  * @return void
  */
-static void sendDMXtask(void * parameters){
-    
-    uint8_t startCode = 0x00;
+static void commitChange(dmx_handle_t dmx){
+    uint32_t none = 0;
+    uint32_t now = (uint32_t) esp_timer_get_time() | 1; //0 means no change
+    atomic_compare_exchange_strong_explicit(&dmx->firstChangeUs, &none, now, memory_order_release, memory_order_relaxed);
 
-    for(;;){
-        sendDMXPipeline(&startCode);
+    if(dmx->sendMode == DMX_SEND_ON_CHANGE){
+        xTaskNotify(dmx->task, DMX_NOTIFY_CHANGE, eSetBits);
     }
 }
 
-/** ----------------------------------------------------------------
- *  ------  The DMX READ feature is CURRENTLY NOT SUPPORTED! -------
- *  
- *  The implementation below is unreliable due to timing problems
- *      with the esp32 development boards
- *      and lack of development time.
- *  ----------------------------------------------------------------
- */
-
 /**
- * @brief Internal function to decode the received uart stream into dmx data.
+ * @brief Internal function to hand a packet (start code + slots) to the UART.
  *
  * @note This function is only expected to be used internally.
- * @param receiveBuffer Pointer to the buffer where the received dmx data should be written to.
- * @param uartEvent Pointer to the Event structure used in UART event queue.
- * 
+ * @note DMA mode streams the buffer in place, the driver mode copies it into the driver's ring buffer
+ *       and refills the FIFO from interrupts. The CPU cycles spent here are tracked per frame, the interrupts of
+ *       either mode aren't. dmxMeasureCpuLoad() compares the modes with the interrupts included.
+ * @param dmx The sending instance.
+ * @param packet The front buffer or the alternate packet, unchanged until the frame left the UART.
+ * @param length Bytes to send, start code included.
+ *
  * @return void
  */
-static void read_uart_stream(uint8_t receiveBuffer[], uart_event_t *uartEvent){
-    /*esp_err_t enoughSpace = uart_get_buffered_data_len(UART_PORT, (size_t*)&uartEvent->size); //check for enough space to receive
+static void transmitPacket(dmx_handle_t dmx, uint8_t *packet, uint16_t length){
+    esp_cpu_cycle_count_t startCycles = esp_cpu_get_cycle_count();
 
-    if(enoughSpace != ESP_OK){
-        setDebugLED(255, 0, 0);
-    }*/
-    int size = uartEvent->size;
-    if (size > RX_BUF_SIZE) size = RX_BUF_SIZE;
-    int bytes_read = uart_read_bytes(UART_PORT, receiveBuffer, size, portMAX_DELAY); //read uart indefinitely
-    
-    if(bytes_read == -1){
-        printf("error whilst reading from UART Buffer! \n");
+    DMX_TRACE(dmx, DMX_TRACE_TX_WRITE, packet[0]);
+    dmx->wireLength = length;
+    dmx->transmitStartUs = esp_timer_get_time();
+    dmx->txDoneTimeoutCounted = false;
+#if DMX_DMA_SUPPORTED
+    if(dmx->transmitMode == DMX_TX_DMA){
+        dmx->dmaBusy = true;
+        if(uhci_transmit(dmx->uhci, packet, length) != ESP_OK){
+            dmx->dmaBusy = false;
+        }
+    } else
+#endif
+    {
+        uart_write_bytes(dmx->port, (const char*) packet, length);
     }
 
-switch(dmxStatus){
-         case BREAK:
-             if(receiveBuffer[0] == 0){ // startBit -> 0x00
-                //setDebugLED(20, 0, 20);
-                //setDebugLED(0, 20, 20);
-                
-                 dmxStatus = RECEIVE_DATA;
-                 lastDmxReadAddress = 1; //break -> DMX Stream starts at the beginning
-                 break;
-             }
-             break;
-         case RECEIVE_DATA:
-             for(int i = 0; i < uartEvent->size; i++){
-
-                 if(lastDmxReadAddress >= 1 && lastDmxReadAddress <= 512){
-                    
-                    dmxReadOutput[lastDmxReadAddress] = receiveBuffer[i]; //assign output to dmx data
-                    
+    uint32_t cycles = esp_cpu_get_cycle_count() - startCycles;
+    DMX_TRACE(dmx, DMX_TRACE_TX_WRITTEN, length);
+    dmx->refresh.avgFrameCycles = dmx->refresh.avgFrameCycles == 0 ? cycles : dmx->refresh.avgFrameCycles + ((int32_t) (cycles - dmx->refresh.avgFrameCycles)) / 16;
+}
 
-                     
-                     lastDmxReadAddress++;
+/**
+ * @brief Internal function to check if the previous frame left the UART completely.
+ *
+ * @note This function is only expected to be used internally.
+ * @note A busy line only counts as a timeout once per frame, and only DMX_TX_DONE_MARGIN_US after the frame should
+ *       have left the wire. Polls that find the UART a few µs behind the estimate are normal at the top rate.
+ * @param dmx The sending instance.
+ * @return true if the line is idle and the next break may start.
+ */
+static bool isTransmitDone(dmx_handle_t dmx){
+    bool done;
+#if DMX_DMA_SUPPORTED
+    if(dmx->transmitMode == DMX_TX_DMA){
+        done = !dmx->dmaBusy && uart_ll_is_tx_idle(UART_LL_GET_HW(dmx->port)); //DMA done only means the FIFO is filled
+    } else
+#endif
+    {
+        done = uart_wait_tx_done(dmx->port, 0) == ESP_OK;
+    }
 
-                     if(lastDmxReadAddress > 512){
-                        dmxStatus = DONE;
-                        break;
-                     }
-                 } else{
-                    dmxStatus = DONE;
-                 }
-             }
-        default:
-             break;
-     }
+    if(!done && !dmx->txDoneTimeoutCounted && dmx->transmitStartUs != 0
+       && esp_timer_get_time() > dmx->transmitStartUs + dmx->wireLength * DMX_SLOT_US + DMX_TX_DONE_MARGIN_US){
+        dmx->stats.txDoneTimeouts++;
+        dmx->txDoneTimeoutCounted = true;
+    }
+    return done;
 }
 
+#if DMX_DMA_SUPPORTED
+/**
+ * @brief Internal DMA callback, called from interrupt context once the whole front buffer was fed into the FIFO.
+ *
+ * @note This function is only expected to be used internally.
+ * @return false, no task was woken.
+ */
+static bool IRAM_ATTR dmxDmaDoneCallback(uhci_controller_handle_t uhci, const uhci_tx_done_event_data_t *event, void *context){
+    dmx_handle_t dmx = context;
+    dmx->dmaBusy = false;
+    return false;
+}
 
 /**
- * @brief Internal handler for receiving dmx.
+ * @brief Internal function to set up the UHCI controller streaming frames from memory into the UART.
  *
  * @note This function is only expected to be used internally.
- * 
- * @return void
+ * @param dmx The sending instance.
+ * @return ESP_OK on success
  */
-static void receiveDMXtask(void * parameters){
-    uint8_t receiveBuffer[RX_BUF_SIZE]; //without malloc() -> static buffer
+static esp_err_t installDMA(dmx_handle_t dmx){
+    const uhci_controller_config_t uhciConfig = {
+        .uart_port = dmx->port,
+        .tx_trans_queue_depth = 2,
+        .max_transmit_size = 513,
+        .max_receive_internal_mem = 513,
+        .dma_burst_size = 32
+    };
+    esp_err_t result = uhci_new_controller(&uhciConfig, &dmx->uhci);
+    if(result != ESP_OK){
+        printf("Failed to install UHCI DMA controller: %d\n", result);
+        return result;
+    }
 
-    uart_event_t uartEvent;
+    const uhci_event_callbacks_t callbacks = {
+        .on_tx_trans_done = dmxDmaDoneCallback
+    };
+    return uhci_register_event_callbacks(dmx->uhci, &callbacks, dmx);
+}
+#endif
 
+/**
+ * @brief Internal function to park the send task once dmxDelete() asked it to stop, it never returns.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The sending instance.
+ *
+ * @return void
+ */
+static void stopSendTask(dmx_handle_t dmx){
+    atomic_store(&dmx->taskStopped, true);
     for(;;){
-        memset(receiveBuffer, 0, RX_BUF_SIZE); //clear buffer
-        if(xQueueReceive(uart_queue, (void *)&uartEvent, portMAX_DELAY) == pdTRUE){ //pdTRUE if an item got successfully received from the queue
-            
-            switch(uartEvent.type){
-                case UART_BREAK:
-                    if((dmxStatus == DONE)){
-                        uart_flush_input(UART_PORT);
-                        xQueueReset(uart_queue);
-                        dmxStatus = BREAK;
-                    } else if(dmxStatus == INACTIVE){
-                        uart_flush_input(UART_PORT);
-                        xQueueReset(uart_queue);
-                        dmxStatus = BREAK;
-                    } 
-                    dmxStatus = BREAK;
-                    break;
-                case UART_DATA:
-                    read_uart_stream(receiveBuffer, &uartEvent);
-                    break;
-                case UART_FRAME_ERR:
-                case UART_PARITY_ERR:
-                case UART_BUFFER_FULL:
-                case UART_FIFO_OVF:
-                default:
-                    xQueueReset(uart_queue);
-                    uart_flush_input(UART_PORT);
-                    dmxStatus = INACTIVE;
-                    break;
-            }
-        } else{
-            
-        }
-     }
-
+        xTaskNotifyWait(0, UINT32_MAX, NULL, portMAX_DELAY); //timers firing until they're deleted only wake it up
+    }
 }
 
 /**
- *  @NOTE: The code below is now safe to use.
+ * @brief Internal function to block the send task until one of the given notification bits is set.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Every wait of the send task goes through here, so DMX_NOTIFY_STOP parks it wherever it is in a frame.
+ * @param dmx The sending instance.
+ * @param pending In/out: bits received but not consumed yet.
+ * @param bits Notification bits to wait for, they're consumed on return.
+ *
+ * @return the bits of the given ones that were set
  */
+static uint32_t waitForNotification(dmx_handle_t dmx, uint32_t *pending, uint32_t bits){
+    while((*pending & bits) == 0){
+        uint32_t value = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &value, portMAX_DELAY);
+        *pending |= value;
+        if(*pending & DMX_NOTIFY_STOP){
+            stopSendTask(dmx);
+        }
+    }
+    uint32_t received = *pending & bits;
+    *pending &= ~bits;
+    return received;
+}
 
 /**
- * @brief configures the esp to send / receive dmx data.
- *        This function can be called multiple times.
- **
- * @note  sends / reads a dmxSignal concurrently!
- * @param sendDMX if true, send dmx forever. Otherwise read dmx.
+ * @brief Internal function to send break and mark after break.
+ *
+ * @note This function is only expected to be used internally.
+ * @note The break is ended by the callback of the break timer (dmxBreakTimerCallback()), so its length doesn't depend
+ *       on when the send task runs. The mark after break is counted from there and ends once the task writes the
+ *       frame: it's at least markUs, longer if another task keeps core 1 busy when the mark elapses.
+ *       No CPU time is spent waiting.
+ * @param dmx The sending instance.
+ * @param pending In/out: notification bits received but not consumed yet.
+ *
  * @return void
  */
-esp_err_t initDMX(bool sendDMX) {
-    const uart_config_t uart_config = {
-        .baud_rate = 250000,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_2,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE
-    };
+static void sendBreak(dmx_handle_t dmx, uint32_t *pending){
+    //Reset or Break > 88µs
+    DMX_TRACE(dmx, DMX_TRACE_TX_BREAK, 0);
+    uart_set_line_inverse(dmx->port, UART_SIGNAL_TXD_INV); //create a break signal by inversing TXD signal
+    esp_timer_start_once(dmx->breakTimer, dmx->breakUs);
+    waitForNotification(dmx, pending, DMX_NOTIFY_BREAK);
+    DMX_TRACE(dmx, DMX_TRACE_TX_MAB, 0);
 
-    //Check if pins are defined
-    if(TXD_PIN == GPIO_NUM_NC || RXD_PIN == GPIO_NUM_NC || rxtxDIR_PIN == GPIO_NUM_NC){
-        printf("No pinout present, please define use setupDMX() first! \n");
-        return ESP_FAIL;
+    //Mark > 12µs
+    int64_t remaining = dmx->breakEndUs + dmx->markUs - esp_timer_get_time();
+    if(remaining > 0){
+        esp_timer_start_once(dmx->stepTimer, remaining); //Mark signal after Break
+        waitForNotification(dmx, pending, DMX_NOTIFY_STEP);
     }
-    
-    uart_param_config(UART_PORT, &uart_config);
-    uart_set_pin(UART_PORT, TXD_PIN, RXD_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+}
+
+/**
+ * @brief Internal pipeline for sending the current front buffer once.
+ *
+ * @note This function is only expected to be used internally.
+ * @note The UART driver streams the frame out after break and mark after break.
+ * @param dmx The sending instance.
+ * @param startCode Pointer to the start code, normally 0x00 for default control.
+ *                                           Special cases covered in the README.
+ * @param pending In/out: notification bits received but not consumed yet.
+ *
+ * @return void
+ */
+static void sendDMXPipeline(dmx_handle_t dmx, uint8_t *startCode, uint32_t *pending){
+    //frame boundary -> pick up the latest data written by producers
+    uint32_t changeUs = swapDMXPackets(dmx);
+    DMX_TRACE(dmx, DMX_TRACE_TX_SNAPSHOT, changeUs != 0);
 
-    gpio_set_direction(rxtxDIR_PIN, GPIO_MODE_OUTPUT); // CONFIGURE GPIO PIN 26 AS OUTPUT
+    sendBreak(dmx, pending);
 
-    gpio_set_level(rxtxDIR_PIN, sendDMX ? 1 : 0); // PULL OUTPUT DIR HIGH TO SEND
-    sendDMXSemaphore = xSemaphoreCreateMutex();
+    //Start Code & DMX PACKET, the front buffer belongs to this task -> no lock needed
+    dmx->frontPacket[0] = *startCode;
+    transmitPacket(dmx, dmx->frontPacket, 1 + dmx->slotCount);
 
-    //Check if the semaphore was successfully created.
-    if (sendDMXSemaphore == NULL) {
-        printf("Failed to create DMX semaphore\n");
-        return ESP_FAIL;
+    if(changeUs != 0){
+        //the start code leaves first, the first slot follows one slot time later
+        recordLatency(dmx, (uint32_t) esp_timer_get_time() + DMX_SLOT_US - changeUs);
     }
+}
 
-    esp_err_t result = uart_driver_install(UART_PORT, RX_BUF_SIZE * 2, 513, 20, &uart_queue, 0);
+/**
+ * @brief Internal function to add a frame interval to the min / avg / max interval and jitter of the health counters.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Only called by the single writer of the interval (send task or UART interrupt), no lock needed.
+ * @param stats The health counters of the instance.
+ * @param interval Time since the previous frame (µs)
+ *
+ * @return void
+ */
+static void updateIntervalStats(dmxStats *stats, uint32_t interval){
+    if(stats->avgIntervalUs == 0){
+        stats->minIntervalUs = interval;
+        stats->avgIntervalUs = interval;
+        stats->maxIntervalUs = interval;
+        return;
+    }
 
+    uint32_t jitter = interval > stats->avgIntervalUs ? interval - stats->avgIntervalUs : stats->avgIntervalUs - interval;
+    stats->avgJitterUs += ((int32_t) (jitter - stats->avgJitterUs)) / 16;
+    if(jitter > stats->maxJitterUs){
+        stats->maxJitterUs = jitter;
+    }
 
-    // Check if uart_queue isn't a null pointer
-    if(uart_queue == NULL){
-        printf("Failed to set an event queue!\n");
+    stats->avgIntervalUs += ((int32_t) (interval - stats->avgIntervalUs)) / 16;
+    if(interval < stats->minIntervalUs){
+        stats->minIntervalUs = interval;
+    }
+    if(interval > stats->maxIntervalUs){
+        stats->maxIntervalUs = interval;
     }
+}
 
-    // Check if installation was successful
-    if (result != ESP_OK) {
-        printf("Failed to install UART driver: %d\n", result);
-    } else if(dmxOperationsTaskHandle != NULL){
-        vTaskDelete(dmxOperationsTaskHandle); // Delete other running dmx operations
-    } else{
-        if(sendDMX){
-            xTaskCreatePinnedToCore(sendDMXtask, "DMX Send Task", 2048, NULL, 1, &dmxOperationsTaskHandle, 1); //PIN TO CORE 1
-        } else{
-            xTaskCreatePinnedToCore(receiveDMXtask, "DMX Receive Task", 4096, NULL, 1, &dmxOperationsTaskHandle, 1); //PIN TO CORE 1
+/**
+ * @brief Internal function to keep track of the achieved refresh rate and jitter.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The sending instance.
+ * @param frameStart Timestamp (µs) the frame was started at.
+ *
+ * @return void
+ */
+static void updateRefreshStats(dmx_handle_t dmx, int64_t frameStart){
+    if(dmx->lastFrameStart != 0){
+        uint32_t interval = (uint32_t) (frameStart - dmx->lastFrameStart);
+        uint32_t period = dmx->framePeriodUs;
+        uint32_t jitter = interval > period ? interval - period : period - interval;
+
+        dmx->avgIntervalUs = dmx->avgIntervalUs == 0 ? interval : dmx->avgIntervalUs + ((int32_t) (interval - dmx->avgIntervalUs)) / 16;
+        updateIntervalStats(&dmx->stats, interval);
+        if(dmx->sendMode == DMX_SEND_PERIODIC){ //event triggered frames don't follow the period
+            dmx->refresh.avgJitterUs += ((int32_t) (jitter - dmx->refresh.avgJitterUs)) / 16;
+            if(jitter > dmx->refresh.maxJitterUs){
+                dmx->refresh.maxJitterUs = jitter;
+            }
         }
     }
-
-    return result;
+    dmx->lastFrameStart = frameStart;
+    dmx->refresh.framesSent++;
 }
 
+/**
+ * @brief Internal function to set a notification bit on the send task from a timer callback.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in interrupt context if the esp_timer ISR dispatch method is available.
+ * @param dmx The sending instance.
+ * @param bit Notification bit to set (DMX_NOTIFY_FRAME or DMX_NOTIFY_STEP)
+ *
+ * @return void
+ */
+static inline void IRAM_ATTR notifySendTask(dmx_handle_t dmx, uint32_t bit){
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xTaskNotifyFromISR(dmx->task, bit, eSetBits, &higherPriorityTaskWoken);
+    if(higherPriorityTaskWoken == pdTRUE){
+        esp_timer_isr_dispatch_need_yield();
+    }
+#else
+    xTaskNotify(dmx->task, bit, eSetBits);
+#endif
+}
 
 /**
- * @brief Clears the uart input buffer.
- * @note  This function is only expected to be used internally.
+ * @brief Internal timer callback, wakes the send task on every frame deadline.
+ *
+ * @note This function is only expected to be used internally.
+ * @param parameters The sending instance.
+ *
  * @return void
  */
-void clearDMXQueue(){
-    uart_flush_input(UART_PORT);
+static void IRAM_ATTR dmxFrameTimerCallback(void *parameters){
+    notifySendTask(parameters, DMX_NOTIFY_FRAME);
 }
 
 /**
- * @brief This function only sets the dmx data to send!
- **       The actual data transfer happens in the init() function.  
- * @note  init() sends the dmxSignal concurrently!
- * @param DMXStream 512 bytes long array containing the dmx data to send
+ * @brief Internal timer callback, wakes the send task once the mark after break or a wait elapsed.
+ *
+ * @note This function is only expected to be used internally.
+ * @param parameters The sending instance.
+ *
  * @return void
  */
-void sendDMX(uint8_t DMXStream[]){
-    xSemaphoreTake(sendDMXSemaphore, portMAX_DELAY);
-    memcpy(dmxPacket, DMXStream, 512);
-    xSemaphoreGive(sendDMXSemaphore);
+static void IRAM_ATTR dmxStepTimerCallback(void *parameters){
+    notifySendTask(parameters, DMX_NOTIFY_STEP);
 }
 
 /**
- * @brief Changes the value of any given dmx channel.
- *        This function only sets the data to send!     
- * @note  init() sends the dmxSignal concurrently!
- *        
- * @param address The address of the dmx channel (1 - 512)
- * @param value The dmx value to send (0 - 255)
+ * @brief Internal timer callback, ends the break and wakes the send task for the mark after break.
+ *
+ * @note This function is only expected to be used internally.
+ * @note The line is flipped back here rather than in the send task, which may only run a scheduler tick later
+ *       if another task of the same priority is running on core 1.
+ * @param parameters The sending instance.
+ *
  * @return void
  */
-void sendAddress(uint16_t address, uint8_t value){
-    if(address >= 1 && address <= 512){
-        xSemaphoreTake(sendDMXSemaphore, portMAX_DELAY);
-        dmxPacket[address-1] = value;
-        xSemaphoreGive(sendDMXSemaphore);
-    } else{
-        printf("Address out of scope (1 - 512): %i", address);
-    }
+static void IRAM_ATTR dmxBreakTimerCallback(void *parameters){
+    dmx_handle_t dmx = parameters;
+
+    uart_set_line_inverse(dmx->port, 0); //stopping break signal by flipping signal back to normal
+    dmx->breakEndUs = esp_timer_get_time();
+    notifySendTask(dmx, DMX_NOTIFY_BREAK);
 }
 
 /**
- * @brief Retuns a received dmx signal (once).
- * 
- * @note  init() reads the dmxSignal concurrently!
- *    
- * @return dmxOutput - pointer to 512 bytes long array containing the dmx data received.
+ * @brief Internal function returning the time the previous frame (null or alternate) took on the wire.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The sending instance.
+ * @return break + mark after break + slots incl. start code (µs)
  */
-uint8_t* readDMX(){
-   return dmxReadOutput;
+static uint32_t frameWireTime(dmx_handle_t dmx){
+    return dmx->breakUs + dmx->markUs + dmx->wireLength * DMX_SLOT_US;
 }
 
 /**
- * @brief Retuns a received dmx channel (once).
- * 
- * @note  init() reads the dmxSignal concurrently!
- * @param address The address of the dmx channel to read from (1 - 512)
- *    
- * @return dmxOutput - data of the dmx channel (0 - 255) 
+ * @brief Internal function to sleep until the previous frame left the wire and the minimum break to break time passed.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The sending instance.
+ * @param pending In/out: notification bits received but not consumed yet.
+ *
+ * @return void
  */
-uint8_t readAddress(uint16_t address){
-    if(address >= 1 && address <= 512){
-        return dmxReadOutput[address];
-    } else{
-        printf("Address out of scope (1 - 512): %i", address);
-        return 0;
+static void waitForFrameEnd(dmx_handle_t dmx, uint32_t *pending){
+    uint32_t wireTime = frameWireTime(dmx);
+    int64_t earliestStart = dmx->lastFrameStart + (wireTime > DMX_MIN_BREAK_TO_BREAK_US ? wireTime : DMX_MIN_BREAK_TO_BREAK_US);
+
+    for(;;){
+        int64_t remaining = earliestStart - esp_timer_get_time();
+        if(remaining <= 0){
+            if(isTransmitDone(dmx)){
+                return;
+            }
+            remaining = DMX_SLOT_US; //the UART is slightly behind the estimate
+        }
+        esp_timer_start_once(dmx->stepTimer, remaining);
+        waitForNotification(dmx, pending, DMX_NOTIFY_STEP);
     }
 }
 
 /**
- * @brief Retuns a range of the original dmx data.
- * 
- * @note please make sure that the startAddress and footprint don't exceed the maximum of channels! (512)
- * @note  init() reads the dmxSignal concurrently!
- * @param startAddress The first address to read from (1 - 512)
- * @param footprint number of channels needed to read from (1 - 512)
- *    
- * @return dmxOutput - data of the dmx channels. IMPORTANT! free memory after use!
+ * @brief Internal function to count a sent alternate start code packet by type.
+ *
+ * @note This function is only expected to be used internally.
+ * @param stats The stats of the sending instance.
+ * @param startCode Start code of the packet.
+ *
+ * @return void
  */
-uint8_t* readFixture(uint16_t startAddress, uint16_t footprint){
-    if(footprint < 1 || footprint > 512){
-        printf("Footprint out of scope (1 - 512): %i", footprint);
-        return NULL;
+static void countAlternate(dmxAlternateStats *stats, uint8_t startCode){
+    switch(startCode){
+        case DMX_START_CODE_TEXT:
+            stats->textFrames++;
+            break;
+        case DMX_START_CODE_TEST:
+            stats->testFrames++;
+            break;
+        case DMX_START_CODE_SIP:
+            stats->sipFrames++;
+            break;
+        default:
+            stats->otherFrames++;
+            break;
     }
-    if(startAddress < 1 || startAddress + footprint > 513){
-        printf("startAddress out of scope (1 - 512) / footprint exeeds scope: %i, footprint: %i, lastAddress: %i", startAddress, footprint, startAddress + footprint -1);
-        return NULL;
+}
+
+/**
+ * @brief Internal function to pick the next queued alternate start code packet if one may go out now.
+ *
+ * @note This function is only expected to be used internally.
+ * @note An alternate frame takes the place of a null frame. It's only sent after alternateInterleave null frames,
+ *       and only if the next null frame still starts within 1 / minNullRate of the previous one.
+ * @param dmx The sending instance.
+ * @param now Start of the frame (µs)
+ *
+ * @return true if dmx->alternate holds a packet to send now
+ */
+static bool takeAlternate(dmx_handle_t dmx, int64_t now){
+    if(uxQueueMessagesWaiting(dmx->alternateQueue) == 0 || dmx->nullSinceAlternate < dmx->alternateInterleave){
+        return false;
+    }
+    if(dmx->minNullRate != 0 && dmx->lastNullStart != 0 && now + dmx->framePeriodUs - dmx->lastNullStart > 1000000 / dmx->minNullRate){
+        dmx->alternateStats.deferred++; //would stretch the null frame interval below the floor
+        return false;
     }
+    return xQueueReceive(dmx->alternateQueue, &dmx->alternate, 0) == pdTRUE;
+}
 
-    uint8_t* fixtureData = (uint8_t*) malloc(footprint); //dynamic allocation to the heap. CALLER HAS TO FREE MEMORY AFTER USE!
-    if(fixtureData == NULL){
+/**
+ * @brief Internal loop to send dmx continuously.
+ *
+ * @note This function is only expected to be used internally.
+ * @note A frame is started on every timer deadline. If the previous frame is still
+ *       on the wire the deadline is skipped and counted as an overrun.
+ * @note In DMX_SEND_ON_CHANGE a commit starts a frame immediately, or right after the current one.
+ *       The timer only sends keepalive frames and is restarted after every frame.
+ * @note Queued alternate start code packets replace a null frame on a timer deadline (never on a change),
+ *       see takeAlternate().
+ * @param parameters The sending instance.
+ *
+ * @return void
+ */
+static void sendDMXtask(void * parameters){
+    dmx_handle_t dmx = parameters;
+
+    uint8_t startCode = DMX_START_CODE_NULL;
+    uint32_t pending = 0;
+
+    for(;;){
+        DMX_TRACE(dmx, DMX_TRACE_TX_SLEEP, 0);
+        uint32_t reason = waitForNotification(dmx, &pending, DMX_NOTIFY_FRAME | DMX_NOTIFY_CHANGE); //sleep until the next frame deadline or change
+        DMX_TRACE(dmx, DMX_TRACE_TX_WAKE, reason);
+
+        bool late = false;
+        if(dmx->sendMode == DMX_SEND_ON_CHANGE){
+            waitForFrameEnd(dmx, &pending);
+        } else if(!isTransmitDone(dmx)){
+            //previous frame still on the wire (at the top rate the UART is a few µs behind the deadline):
+            //start right after it instead of skipping the period, the deadlines are re-anchored on this frame
+            if(frameWireTime(dmx) > dmx->framePeriodUs){
+                dmx->refresh.overruns++; //the previous frame was longer than the period (e.g. an alternate frame)
+                DMX_TRACE(dmx, DMX_TRACE_TX_OVERRUN, 0);
+            }
+            waitForFrameEnd(dmx, &pending);
+            late = true;
+        }
+        DMX_TRACE(dmx, DMX_TRACE_TX_DRAINED, 0);
+
+        int64_t frameStart = esp_timer_get_time();
+        updateRefreshStats(dmx, frameStart);
+        if(reason == DMX_NOTIFY_FRAME && takeAlternate(dmx, frameStart)){
+            sendBreak(dmx, &pending);
+            transmitPacket(dmx, dmx->alternate.packet, dmx->alternate.length);
+            countAlternate(&dmx->alternateStats, dmx->alternate.packet[0]);
+            dmx->nullSinceAlternate = 0;
+        } else{
+            sendDMXPipeline(dmx, &startCode, &pending);
+            dmx->alternateStats.nullFrames++;
+            dmx->lastNullStart = frameStart;
+            if(dmx->nullSinceAlternate < UINT8_MAX){
+                dmx->nullSinceAlternate++;
+            }
+        }
+
+        if(dmx->sendMode == DMX_SEND_ON_CHANGE || late){
+            esp_timer_stop(dmx->frameTimer); //next deadline / keepalive one period after this frame
+            esp_timer_start_periodic(dmx->frameTimer, dmx->framePeriodUs);
+            pending &= ~DMX_NOTIFY_FRAME; //a deadline that passed while this frame waited is served by it
+        }
+    }
+}
+
+/**
+ * @brief Internal function to create one of the send timers.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The sending instance.
+ * @param timer Pointer to the timer handle to create.
+ * @param callback Timer callback.
+ * @param name Name of the timer.
+ * @return ESP_OK on success
+ */
+static esp_err_t createSendTimer(dmx_handle_t dmx, esp_timer_handle_t *timer, esp_timer_cb_t callback, const char *name){
+    const esp_timer_create_args_t timerArgs = {
+        .callback = callback,
+        .arg = dmx,
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+        .dispatch_method = ESP_TIMER_ISR,
+#else
+        .dispatch_method = ESP_TIMER_TASK,
+#endif
+        .name = name,
+        .skip_unhandled_events = true
+    };
+    esp_err_t result = esp_timer_create(&timerArgs, timer);
+    if(result != ESP_OK){
+        printf("Failed to create DMX timer %s: %d\n", name, result);
+    }
+    return result;
+}
+
+/**
+ * @brief Internal function to (re)start the frame timer with the current refresh rate.
+ *
+ * @note This function is only expected to be used internally.
+ * @note The period never drops below the time the frame takes on the wire
+ *       or the minimum break to break time.
+ * @param dmx The sending instance.
+ * @return ESP_OK on success
+ */
+static esp_err_t startFrameTimer(dmx_handle_t dmx){
+    if(dmx->frameTimer == NULL){
+        esp_err_t result = createSendTimer(dmx, &dmx->frameTimer, dmxFrameTimerCallback, "dmx frame");
+        if(result == ESP_OK){
+            result = createSendTimer(dmx, &dmx->stepTimer, dmxStepTimerCallback, "dmx step");
+        }
+        if(result == ESP_OK){
+            result = createSendTimer(dmx, &dmx->breakTimer, dmxBreakTimerCallback, "dmx break");
+        }
+        if(result != ESP_OK){
+            return result;
+        }
+    } else{
+        esp_timer_stop(dmx->frameTimer); //returns an error if the timer isn't running, that's fine
+    }
+
+    dmx->lastFrameStart = 0; //don't count the restart as jitter
+    dmx->framePeriodUs = dmxFramePeriodUs(dmx->refreshRate, dmx->slotCount, dmx->breakUs, dmx->markUs);
+    return esp_timer_start_periodic(dmx->frameTimer, dmx->framePeriodUs);
+}
+
+/**
+ * @brief Internal function to check whether a frame is relevant for a subscriber.
+ *
+ * @note This function is only expected to be used internally.
+ * @param subscriber The subscriber.
+ * @param frame The frame just published.
+ *
+ * @return true if the subscriber wants every frame or a slot in its range changed
+ */
+static bool isFrameRelevant(const struct dmxSubscriber *subscriber, const dmxRxFrame *frame){
+    uint16_t first = subscriber->config.firstAddress;
+    return first == 0 || dmxDirtyAny(&frame->changes, first, subscriber->config.lastAddress); //the first frame marks every slot
+}
+
+/**
+ * @brief Internal function to notify the subscribers of an instance about a published frame.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in the UART interrupt (tasks woken are switched to when it returns) or, for fade / blackout frames,
+ *       in the esp_timer task, never with rxLock held. The targets are copied under subscriberLock and notified
+ *       after releasing it.
+ * @param dmx The receiving instance.
+ * @param frame The frame just published.
+ * @param yield Set to pdTRUE if a woken task has a higher priority than the running one.
+ *
+ * @return void
+ */
+static void notifySubscribers(dmx_handle_t dmx, const dmxRxFrame *frame, BaseType_t *yield){
+    dmxFrameEvent event = {.sequence = frame->sequence, .timestamp = frame->timestamp, .length = frame->length};
+    dmxSubscribeConfig targets[DMX_MAX_SUBSCRIBERS];
+    int count = 0;
+
+    portENTER_CRITICAL_ISR(&dmx->subscriberLock);
+    for(int i = 0; i < DMX_MAX_SUBSCRIBERS; i++){
+        const struct dmxSubscriber *subscriber = &dmx->subscribers[i];
+        if(subscriber->active && isFrameRelevant(subscriber, frame)){
+            targets[count++] = subscriber->config;
+        }
+    }
+    dmx->dispatching += count > 0;
+    portEXIT_CRITICAL_ISR(&dmx->subscriberLock);
+    if(count == 0){
+        return;
+    }
+
+    for(int i = 0; i < count; i++){
+        switch(targets[i].type){
+            case DMX_NOTIFY_BY_TASK:
+                xTaskNotifyFromISR(targets[i].task, frame->sequence, eSetValueWithOverwrite, yield);
+                break;
+            case DMX_NOTIFY_BY_QUEUE:
+                xQueueSendFromISR(targets[i].queue, &event, yield); //a full queue means the consumer is behind anyway
+                break;
+            case DMX_NOTIFY_BY_CALLBACK:
+                targets[i].callback(dmx, frame, targets[i].context);
+                break;
+        }
+    }
+
+    portENTER_CRITICAL_ISR(&dmx->subscriberLock);
+    dmx->dispatching--;
+    portEXIT_CRITICAL_ISR(&dmx->subscriberLock);
+}
+
+/**
+ * @brief Internal function to publish the write packet of the receive buffer.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Called with rxLock held, by the interrupt or the signal timer. Slots beyond length read as 0.
+ *       The channels that changed since the previous frame are recorded in frame->changes.
+ *       Subscribers aren't notified here: the frame is held in dmx->published until the caller released rxLock,
+ *       see dispatchPublished().
+ * @param dmx The receiving instance.
+ * @param length Number of bytes in the write packet, start code included.
+ * @param timestamp Time the frame was complete (µs)
+ *
+ * @return packet for the next frame
+ */
+static uint8_t* publishFrame(dmx_handle_t dmx, uint16_t length, int64_t timestamp){
+    const dmxRxFrame *previous = dmxRxBufferLatest(&dmx->rxBuffer);
+    uint8_t *next = dmxRxBufferPublish(&dmx->rxBuffer, length, timestamp);
+
+    if(dmxRxBufferLatest(&dmx->rxBuffer) != previous){ //not dropped
+        dmx->published = dmxRxBufferAcquire(&dmx->rxBuffer); //held, so it can't be reused before the subscribers saw it
+    }
+    return next;
+}
+
+/**
+ * @brief Internal function to notify the subscribers about the frame publishFrame() held back, and to call the
+ *        handler publishAlternateFrame() picked for an alternate start code frame.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in the UART interrupt, called with rxLock held. The lock is released while subscribers and handler
+ *       run and taken again before returning, so they never run inside the critical section. The alternate packet
+ *       stays valid meanwhile, only this interrupt decodes into it.
+ * @param dmx The receiving instance.
+ *
+ * @return void
+ */
+static void dispatchPublished(dmx_handle_t dmx){
+    const dmxRxFrame *frame = dmx->published;
+    struct dmxStartCodeEntry target = dmx->alternateTarget;
+    if(frame == NULL && !target.active){
+        return;
+    }
+    dmx->published = NULL;
+    dmx->alternateTarget.active = false;
+    dmx->alternateDispatching = target.active;
+
+    portEXIT_CRITICAL_ISR(&dmx->rxLock);
+    if(frame != NULL){
+        notifySubscribers(dmx, frame, &dmx->rxYield);
+        dmxRxBufferRelease(&dmx->rxBuffer, frame);
+    }
+    if(target.active){
+        target.handler(dmx, dmx->alternateFrame, dmx->alternateLength, target.context);
+    }
+    portENTER_CRITICAL_ISR(&dmx->rxLock);
+    dmx->alternateDispatching = false;
+}
+
+/**
+ * @brief Internal decoder callback, publishes a complete frame and returns the buffer for the next one.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in the UART interrupt.
+ * @param context The receiving instance.
+ * @param packet The complete frame: [0] start code, [1 - length-1] slots (the write packet of the receive buffer).
+ * @param length Number of bytes in packet, start code included.
+ *
+ * @return buffer for the next frame
+ */
+static uint8_t* publishReceivedFrame(void *context, uint8_t *packet, uint16_t length){
+    dmx_handle_t dmx = context;
+    int64_t now = esp_timer_get_time();
+
+    setStatus(dmx, DONE);
+    if(dmx->lastReceived != 0){
+        updateIntervalStats(&dmx->stats, (uint32_t) (now - dmx->lastReceived));
+    }
+    dmx->lastReceived = now;
+    dmxSignalFrame(&dmx->signal, now);
+    DMX_TRACE(dmx, DMX_TRACE_RX_PUBLISH, length);
+    dmx->startCodeStats.nullFrames++;
+    dmx->startCodeStats.lastStartCode = DMX_START_CODE_NULL;
+    dmx->startCodeStats.lastLength = length;
+    return publishFrame(dmx, length, now);
+}
+
+/**
+ * @brief Internal decoder callback for frames with an alternate start code, hands them to the registered handler.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in the UART interrupt, with rxLock held. The dimmer frames aren't touched, SIPs with an invalid checksum
+ *       are dropped. The handler is only picked here and called by dispatchPublished().
+ * @param context The receiving instance.
+ * @param packet The complete frame: [0] start code, [1 - length-1] slots.
+ * @param length Number of bytes in packet, start code included.
+ *
+ * @return buffer for the next alternate frame (the same one, handlers copy what they need)
+ */
+static uint8_t* publishAlternateFrame(void *context, uint8_t *packet, uint16_t length){
+    dmx_handle_t dmx = context;
+    dmxStartCodeStats *stats = &dmx->startCodeStats;
+    uint8_t startCode = packet[0];
+
+    stats->lastStartCode = startCode;
+    stats->lastLength = length;
+    switch(startCode){
+        case DMX_START_CODE_TEXT:
+            stats->textPackets++;
+            break;
+        case DMX_START_CODE_TEST:
+            if(!dmxIsTestPacket(packet, length)){
+                stats->testErrors++;
+                return packet;
+            }
+            stats->testPackets++;
+            break;
+        case DMX_START_CODE_SIP: {
+            dmxSipPacket sip;
+            if(!dmxParseSip(packet, length, &sip)){
+                stats->sipErrors++;
+                return packet;
+            }
+            stats->sipPackets++;
+            break;
+        }
+        default:
+            stats->otherPackets++;
+            break;
+    }
+
+    for(int i = 0; i < DMX_MAX_START_CODE_HANDLERS; i++){
+        const struct dmxStartCodeEntry *entry = &dmx->startCodeHandlers[i];
+        if(entry->active && entry->startCode == startCode){
+            dmx->alternateTarget = *entry; //called by dispatchPublished() once rxLock is released
+            dmx->alternateFrame = packet;
+            dmx->alternateLength = length;
+            return packet;
+        }
+    }
+    stats->unhandled++;
+    return packet;
+}
+
+/**
+ * @brief Internal UART interrupt, decodes breaks and slots straight from the RX FIFO.
+ *
+ * @note This function is only expected to be used internally.
+ * @note No driver, no event queue: the FIFO is drained into the decoder on every threshold,
+ *       timeout and break interrupt, complete frames are published from here.
+ * @param parameters The receiving instance.
+ *
+ * @return void
+ */
+static void dmxReceiveISR(void *parameters){
+    dmx_handle_t dmx = parameters;
+    uart_dev_t *uart = UART_LL_GET_HW(dmx->port);
+    uint8_t fifo[SOC_UART_FIFO_LEN];
+
+    portENTER_CRITICAL_ISR(&dmx->rxLock);
+    DMX_TRACE(dmx, DMX_TRACE_RX_ENTER, 0);
+    for(;;){
+        uint32_t status = uart_ll_get_intsts_mask(uart) & DMX_RX_INTERRUPTS;
+        if(status == 0){
+            break;
+        }
+
+        uint32_t length = uart_ll_get_rxfifo_len(uart);
+        if(length > sizeof(fifo)){
+            length = sizeof(fifo);
+        }
+        uart_ll_read_rxfifo(uart, fifo, length);
+        uart_ll_clr_intsts_mask(uart, status);
+
+        if(status & UART_INTR_BRK_DET){
+            //the break itself ends up in the FIFO as a null byte (with a framing error)
+            if(length > 0 && fifo[length - 1] == 0x00){
+                length--;
+            }
+            dmxDecoderBytes(&dmx->decoder, fifo, length);
+            dispatchPublished(dmx); //a full frame may have ended right before the break
+            DMX_TRACE(dmx, DMX_TRACE_RX_BREAK, length);
+            dmxDecoderBreak(&dmx->decoder);
+            setStatus(dmx, BREAK);
+        } else if(status & (UART_INTR_FRAM_ERR | UART_INTR_PARITY_ERR | UART_INTR_RXFIFO_OVF)){
+            dmx->stats.frameErrors += (status & UART_INTR_FRAM_ERR) != 0;
+            dmx->stats.parityErrors += (status & UART_INTR_PARITY_ERR) != 0;
+            dmx->stats.fifoOverflows += (status & UART_INTR_RXFIFO_OVF) != 0;
+            DMX_TRACE(dmx, DMX_TRACE_RX_ERROR, status);
+            uart_ll_rxfifo_rst(uart);
+            dmxDecoderError(&dmx->decoder);
+            setStatus(dmx, INACTIVE);
+        } else{
+            dmxDecoderBytes(&dmx->decoder, fifo, length);
+            DMX_TRACE(dmx, DMX_TRACE_RX_BYTES, length);
+            if(dmx->decoder.state == DMX_DECODER_SLOTS){
+                setStatus(dmx, RECEIVE_DATA);
+            }
+        }
+        dispatchPublished(dmx);
+    }
+    DMX_TRACE(dmx, DMX_TRACE_RX_EXIT, 0);
+    portEXIT_CRITICAL_ISR(&dmx->rxLock);
+
+    BaseType_t yield = dmx->rxYield;
+    dmx->rxYield = pdFALSE;
+    portYIELD_FROM_ISR(yield);
+}
+
+/**
+ * @brief Internal timer callback, detects loss of signal and steps the hold / fade / blackout output.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in the esp_timer task every DMX_SIGNAL_TICK_US. Faded frames are published like received ones
+ *       (new sequence, subscribers are notified), the frame the decoder had in progress is dropped.
+ *       The copy and the scaling run outside rxLock, it's only taken for the tick and the publish. The publish is
+ *       skipped if a frame arrived in between, a faded frame never replaces live data. Subscribers
+ *       are notified after it's released, holding the frame so the interrupt can't reuse it meanwhile.
+ * @param parameters The receiving instance.
+ *
+ * @return void
+ */
+static void dmxSignalTimerCallback(void *parameters){
+    dmx_handle_t dmx = parameters;
+    BaseType_t yield = pdFALSE;
+
+    portENTER_CRITICAL(&dmx->rxLock);
+    int64_t now = esp_timer_get_time();
+    uint32_t events = dmxSignalTick(&dmx->signal, now);
+    uint8_t level = dmx->signal.level;
+    portEXIT_CRITICAL(&dmx->rxLock);
+
+    //heldPacket and fadePacket belong to this timer, only the swap into the receive buffer needs rxLock
+    if(events & DMX_SIGNAL_EVENT_LOST){
+        const dmxRxFrame *latest = dmxRxBufferAcquire(&dmx->rxBuffer); //held, so the interrupt can't reuse it while it's copied
+        memcpy(dmx->heldPacket, latest->packet, sizeof(dmx->heldPacket));
+        dmx->heldLength = latest->length;
+        dmxRxBufferRelease(&dmx->rxBuffer, latest);
+    }
+    if((events & DMX_SIGNAL_EVENT_OUTPUT) && dmx->heldLength > 0){
+        dmxSignalScale(dmx->heldPacket, dmx->fadePacket, dmx->heldLength, level);
+
+        const dmxRxFrame *frame = NULL;
+        portENTER_CRITICAL(&dmx->rxLock);
+        //the interrupt may have received a frame since the tick, it stays and the next tick reports the restore
+        if(dmx->signal.state == DMX_SIGNAL_LOST && dmx->signal.lastFrameUs <= dmx->signal.lostUs){
+            memcpy(dmxRxBufferWritePacket(&dmx->rxBuffer), dmx->fadePacket, dmx->heldLength);
+            dmxDecoderRestart(&dmx->decoder, publishFrame(dmx, dmx->heldLength, now));
+            frame = dmx->published;
+            dmx->published = NULL;
+        }
+        portEXIT_CRITICAL(&dmx->rxLock);
+
+        if(frame != NULL){
+            notifySubscribers(dmx, frame, &yield);
+            dmxRxBufferRelease(&dmx->rxBuffer, frame);
+        }
+    }
+
+    if(events & DMX_SIGNAL_EVENT_LOST){
+        setStatus(dmx, INACTIVE);
+    }
+    if((events & (DMX_SIGNAL_EVENT_LOST | DMX_SIGNAL_EVENT_RESTORED)) && dmx->signalLoss.callback != NULL){
+        dmx->signalLoss.callback(dmx, (events & DMX_SIGNAL_EVENT_LOST) ? DMX_SIGNAL_LOST : DMX_SIGNAL_PRESENT, dmx->signalLoss.context);
+    }
+    if(yield == pdTRUE){
+        taskYIELD();
+    }
+}
+
+/**
+ * @brief Internal function to start the periodic loss of signal check of a receiving instance.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The receiving instance.
+ * @return ESP_OK on success
+ */
+static esp_err_t startSignalTimer(dmx_handle_t dmx){
+    const esp_timer_create_args_t timerArgs = {
+        .callback = dmxSignalTimerCallback,
+        .arg = dmx,
+        .dispatch_method = ESP_TIMER_TASK, //copies / scales a frame, too long for the timer interrupt
+        .name = "dmx signal",
+        .skip_unhandled_events = true
+    };
+    esp_err_t result = esp_timer_create(&timerArgs, &dmx->signalTimer);
+    if(result != ESP_OK){
+        printf("Failed to create DMX timer dmx signal: %d\n", result);
+        return result;
+    }
+    return esp_timer_start_periodic(dmx->signalTimer, DMX_SIGNAL_TICK_US);
+}
+
+/**
+ * @brief Internal function to route the UART RX interrupt to the decoder.
+ *
+ * @note This function is only expected to be used internally.
+ * @note The UART driver isn't installed for receiving, the interrupt reads the FIFO directly.
+ * @param dmx The receiving instance.
+ * @return ESP_OK on success
+ */
+static esp_err_t installReceiveInterrupt(dmx_handle_t dmx){
+    uart_dev_t *uart = UART_LL_GET_HW(dmx->port);
+
+    dmxRxBufferInit(&dmx->rxBuffer);
+    dmxDecoderInit(&dmx->decoder, dmxRxBufferWritePacket(&dmx->rxBuffer), publishReceivedFrame, dmx);
+    dmxDecoderSetAlternate(&dmx->decoder, dmx->alternatePacket, publishAlternateFrame);
+    dmxSignalInit(&dmx->signal, dmx->signalLoss.policy, dmx->signalLoss.timeoutMs, dmx->signalLoss.holdMs, dmx->signalLoss.fadeMs);
+
+    uart_ll_disable_intr_mask(uart, UINT32_MAX);
+    uart_ll_rxfifo_rst(uart);
+    uart_ll_clr_intsts_mask(uart, UINT32_MAX);
+    uart_ll_set_rxfifo_full_thr(uart, DMX_RX_FIFO_THRESHOLD);
+    uart_ll_set_rx_tout(uart, DMX_RX_TIMEOUT_BITS);
+
+    esp_err_t result = esp_intr_alloc(uart_periph_signal[dmx->port].irq, ESP_INTR_FLAG_LEVEL1, dmxReceiveISR, dmx, &dmx->rxInterrupt);
+    if(result != ESP_OK){
+        printf("Failed to allocate the UART interrupt: %d\n", result);
+        return result;
+    }
+
+    uart_ll_ena_intr_mask(uart, DMX_RX_INTERRUPTS);
+    return startSignalTimer(dmx);
+}
+
+/**
+ *  @NOTE: The code below is now safe to use.
+ */
+
+/**
+ * @brief Creates a DMX instance on its own UART port and starts sending / receiving.
+ *        Instances on different ports run independently and concurrently.
+ *
+ * @note  UART_NUM_0 is usually connected to the serial console, only use it if it's free.
+ * @param config Port, pinout, direction and send settings of the instance.
+ * @param handle Pointer to the handle of the created instance.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxCreate(const dmxConfig *config, dmx_handle_t *handle){
+    const uart_config_t uart_config = {
+        .baud_rate = 250000,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_2,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE
+    };
+
+    if(config->port < 0 || config->port >= UART_NUM_MAX){
+        printf("UART port out of scope (0 - %i): %i\n", UART_NUM_MAX - 1, config->port);
+        return ESP_ERR_INVALID_ARG;
+    }
+    //Check if pins are defined
+    if(config->pinout.tx == GPIO_NUM_NC || config->pinout.rx == GPIO_NUM_NC || config->pinout.dir == GPIO_NUM_NC){
+        printf("No pinout present, please define use setupDMX() first! \n");
+        return ESP_FAIL;
+    }
+    if(config->transmitMode == DMX_TX_DMA && !DMX_DMA_SUPPORTED){
+        printf("DMA transmit mode isn't supported on this chip\n");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if(config->slotCount != 0 && (config->slotCount < DMX_MIN_SLOTS || config->slotCount > DMX_MAX_SLOTS)){
+        printf("Slot count out of scope (%i - %i): %i\n", DMX_MIN_SLOTS, DMX_MAX_SLOTS, config->slotCount);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    //the DMA streams frames straight out of the instance, so it has to live in DMA capable memory
+    uint32_t caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT | (config->transmitMode == DMX_TX_DMA ? MALLOC_CAP_DMA : 0);
+    dmx_handle_t dmx = heap_caps_calloc(1, sizeof(struct dmxInstance), caps);
+    if(dmx == NULL){
         printf("Memory allocation failed");
-        return NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    dmx_handle_t none = NULL;
+    if(!atomic_compare_exchange_strong(&dmxInstances[config->port], &none, dmx)){ //concurrent dmxCreate() calls can't both win
+        printf("UART port %i is already used by another DMX instance\n", config->port);
+        heap_caps_free(dmx);
+        return ESP_ERR_INVALID_STATE;
     }
 
-    memcpy(fixtureData, &dmxReadOutput[startAddress], footprint); //copy a part of the original dmx output
+    dmx->port = config->port;
+    dmx->pinout = config->pinout;
+    dmx->send = config->send;
+    dmx->status = config->send ? SEND : INACTIVE;
+    dmx->transmitMode = config->transmitMode;
+    dmx->sendMode = config->sendMode;
+    dmx->refreshRate = config->refreshRate != 0 ? config->refreshRate : DMX_DEFAULT_REFRESH_RATE;
+    dmx->slotCount = config->slotCount != 0 ? config->slotCount : DMX_MAX_SLOTS;
+    dmx->breakUs = config->breakUs != 0 ? config->breakUs : delayBreakMICROSEC;
+    dmx->markUs = config->markUs != 0 ? config->markUs : delayMarkMICROSEC;
+    dmx->frontPacket = dmx->packet[0];
+    dmx->backPacket = dmx->packet[1];
+    dmx->wireLength = 1 + dmx->slotCount;
+    dmx->alternateInterleave = config->alternateInterleave != 0 ? config->alternateInterleave : DMX_DEFAULT_ALTERNATE_INTERLEAVE;
+    dmx->minNullRate = config->minNullRate;
+    dmxTxFrameInit(&dmx->frame);
+#if DMX_TRACE_ENABLED
+    dmxTraceInit(&dmx->trace);
+#endif
+    dmx->signalLoss = config->signalLoss;
+    portMUX_INITIALIZE(&dmx->subscriberLock);
+    portMUX_INITIALIZE(&dmx->rxLock);
 
-    return fixtureData;
-}
\ No newline at end of file
+    uart_param_config(dmx->port, &uart_config);
+    uart_set_pin(dmx->port, dmx->pinout.tx, dmx->pinout.rx, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+
+    gpio_set_direction(dmx->pinout.dir, GPIO_MODE_OUTPUT); // CONFIGURE GPIO PIN 26 AS OUTPUT
+
+    gpio_set_level(dmx->pinout.dir, dmx->send ? 1 : 0); // PULL OUTPUT DIR HIGH TO SEND
+    dmx->writeMutex = xSemaphoreCreateMutex();
+
+    //Check if the semaphore was successfully created.
+    if (dmx->writeMutex == NULL) {
+        printf("Failed to create DMX semaphore\n");
+        dmxDelete(dmx);
+        return ESP_FAIL;
+    }
+
+    esp_err_t result;
+#if DMX_DMA_SUPPORTED
+    if(dmx->send && dmx->transmitMode == DMX_TX_DMA){
+        result = installDMA(dmx); //the DMA feeds the UART directly, no UART driver needed
+    } else
+#endif
+    {
+        if(dmx->send){
+            result = uart_driver_install(dmx->port, RX_BUF_SIZE * 2, 513, 0, NULL, 0);
+        } else{
+            result = installReceiveInterrupt(dmx); //decoded in the interrupt, no driver / event queue
+        }
+    }
+
+    // Check if installation was successful
+    if (result != ESP_OK) {
+        printf("Failed to install UART driver: %d\n", result);
+        dmxDelete(dmx);
+        return result;
+    }
+
+    if(dmx->send){
+        dmx->alternateQueue = xQueueCreate(DMX_ALTERNATE_QUEUE_LENGTH, sizeof(struct dmxAlternateFrame));
+        if(dmx->alternateQueue == NULL){
+            printf("Failed to create the alternate start code queue\n");
+            dmxDelete(dmx);
+            return ESP_ERR_NO_MEM;
+        }
+        if(xTaskCreatePinnedToCore(sendDMXtask, "DMX Send Task", 2048, dmx, 1, &dmx->task, 1) != pdPASS){ //PIN TO CORE 1
+            printf("Failed to create the DMX send task\n");
+            dmx->task = NULL;
+            dmxDelete(dmx);
+            return ESP_ERR_NO_MEM;
+        }
+        result = startFrameTimer(dmx);
+    }
+
+    if(result != ESP_OK){
+        dmxDelete(dmx);
+        return result;
+    }
+
+    *handle = dmx;
+    return ESP_OK;
+}
+
+/**
+ * @brief Internal timer callback of waitForTimerCallbacks().
+ *
+ * @note This function is only expected to be used internally.
+ * @param parameters The flag to set (atomic_bool).
+ *
+ * @return void
+ */
+static void IRAM_ATTR timerBarrierCallback(void *parameters){
+    atomic_store((atomic_bool*) parameters, true);
+}
+
+/**
+ * @brief Internal function to wait until timer callbacks that were already dispatched returned.
+ *
+ * @note This function is only expected to be used internally.
+ * @note esp_timer_stop() / esp_timer_delete() don't wait for a callback that is running, or was picked and is about
+ *       to run, on the other core. Callbacks of one dispatch method run one after the other, so once a timer started
+ *       afterwards fired, the earlier ones are done.
+ * @param method Dispatch method of the timers to wait for.
+ *
+ * @return void
+ */
+static void waitForTimerCallbacks(esp_timer_dispatch_t method){
+    atomic_bool fired = false;
+    esp_timer_handle_t barrier;
+    const esp_timer_create_args_t timerArgs = {
+        .callback = timerBarrierCallback,
+        .arg = &fired,
+        .dispatch_method = method,
+        .name = "dmx barrier"
+    };
+
+    if(esp_timer_create(&timerArgs, &barrier) != ESP_OK){
+        vTaskDelay(pdMS_TO_TICKS(10) + 1); //no barrier, give a running callback time to return
+        return;
+    }
+    esp_timer_start_once(barrier, 0);
+    while(!atomic_load(&fired)){
+        vTaskDelay(1);
+    }
+    esp_timer_delete(barrier);
+}
+
+/**
+ * @brief Stops an instance, releases its UART port and frees its memory.
+ *
+ * @note  Waits until the send task stopped using its timers (at most one break / mark after break) and until timer
+ *        callbacks already running on another core returned.
+ *        A frame in progress is cut off, the TX line is left idle (mark).
+ * @param handle The instance to delete, the handle is invalid afterwards.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxDelete(dmx_handle_t handle){
+    if(handle == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    //the timers notify the send task and the task arms them: park the task first, then delete the timers, then the task
+    if(handle->task != NULL){
+        xTaskNotify(handle->task, DMX_NOTIFY_STOP, eSetBits);
+        while(!atomic_load(&handle->taskStopped)){
+            vTaskDelay(1);
+        }
+    }
+    if(handle->frameTimer != NULL){
+        esp_timer_stop(handle->frameTimer);
+        esp_timer_delete(handle->frameTimer);
+    }
+    if(handle->stepTimer != NULL){
+        esp_timer_stop(handle->stepTimer);
+        esp_timer_delete(handle->stepTimer);
+    }
+    if(handle->breakTimer != NULL){
+        esp_timer_stop(handle->breakTimer);
+        esp_timer_delete(handle->breakTimer);
+    }
+    if(handle->frameTimer != NULL){
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+        waitForTimerCallbacks(ESP_TIMER_ISR); //a callback already dispatched may still notify the task
+#else
+        waitForTimerCallbacks(ESP_TIMER_TASK);
+#endif
+    }
+    if(handle->task != NULL){
+        vTaskDelete(handle->task); // Delete running dmx operations of this instance
+    }
+    if(handle->send){
+        uart_set_line_inverse(handle->port, 0); //deleted during a break, the line would stay low
+    }
+#if DMX_DMA_SUPPORTED
+    if(handle->uhci != NULL){
+        uhci_del_controller(handle->uhci);
+    }
+#endif
+    if(handle->signalTimer != NULL){
+        esp_timer_stop(handle->signalTimer);
+        esp_timer_delete(handle->signalTimer);
+        waitForTimerCallbacks(ESP_TIMER_TASK); //a fade frame may still be published into this instance
+    }
+    if(handle->rxInterrupt != NULL){
+        uart_ll_disable_intr_mask(UART_LL_GET_HW(handle->port), DMX_RX_INTERRUPTS);
+        esp_intr_free(handle->rxInterrupt);
+    }
+    if(uart_is_driver_installed(handle->port)){
+        uart_driver_delete(handle->port);
+    }
+    if(handle->writeMutex != NULL){
+        vSemaphoreDelete(handle->writeMutex);
+    }
+    if(handle->alternateQueue != NULL){
+        vQueueDelete(handle->alternateQueue);
+    }
+
+    dmx_handle_t self = handle;
+    atomic_compare_exchange_strong(&dmxInstances[handle->port], &self, NULL); //releases the port
+    if(defaultInstance == handle){
+        defaultInstance = NULL;
+    }
+
+    heap_caps_free(handle);
+    return ESP_OK;
+}
+
+/**
+ * @brief configures the esp to send / receive dmx data.
+ *        This function can be called multiple times.
+ **
+ * @note  sends / reads a dmxSignal concurrently!
+ * @note  Runs the default instance on UART_NUM_2, use dmxCreate() for more universes.
+ * @param sendDMX if true, send dmx forever. Otherwise read dmx.
+ * @return void
+ */
+esp_err_t initDMX(bool sendDMX) {
+    if(defaultInstance != NULL){
+        dmxDelete(defaultInstance); // Delete other running dmx operations
+    }
+
+    defaultConfig.send = sendDMX;
+    esp_err_t result = dmxCreate(&defaultConfig, &defaultInstance);
+    if(result == ESP_OK){
+        dmxStatus = defaultInstance->status;
+    }
+
+    return result;
+}
+
+/**
+ * @brief Returns the default instance used by initDMX(), sendDMX(), readDMX(), ...
+ *
+ * @return handle of the default instance, NULL if initDMX() wasn't called successfully.
+ */
+dmx_handle_t dmxGetDefault(){
+    return defaultInstance;
+}
+
+/**
+ * @brief Returns the decoder status of an instance.
+ *
+ * @param handle The instance.
+ * @return status of the instance
+ */
+DMXStatus dmxGetStatus(dmx_handle_t handle){
+    return handle->status;
+}
+
+/**
+ * @brief Returns the health counters of an instance: frames, achieved rate, frame interval & jitter and errors.
+ *
+ * @note  Never locks, the counters are plain words with a single writer each (send task or UART interrupt).
+ *        Every field is consistent on its own, fields may be one frame apart from each other.
+ * @param handle The instance.
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetStats(dmx_handle_t handle, dmxStats *stats){
+    *stats = handle->stats;
+    stats->framesSent = handle->refresh.framesSent;
+    stats->framesReceived = handle->decoder.stats.frames;
+    stats->refreshRate = stats->avgIntervalUs > 0 ? 1000000.0f / stats->avgIntervalUs : 0.0f;
+    stats->bufferFull = handle->rxBuffer.dropped;
+    stats->shortFrames = handle->decoder.stats.shortFrames;
+    stats->longFrames = handle->decoder.stats.longFrames;
+}
+
+/**
+ * @brief Copies the trace of an instance (binary), oldest event first.
+ *
+ * @note  Only available if the library is built with DMX_TRACE_ENABLED=1. Lock-free, the instance keeps running.
+ *        Timestamps are CPU cycles of the core the send task / UART interrupt runs on.
+ * @param handle The instance.
+ * @param entries Destination of at least max entries.
+ * @param max Maximum number of entries to copy (the ring holds DMX_TRACE_ENTRIES).
+ * @return number of entries copied, 0 if tracing isn't compiled in
+ */
+size_t dmxTraceDump(dmx_handle_t handle, dmxTraceEntry *entries, size_t max){
+#if DMX_TRACE_ENABLED
+    return dmxTraceRead(&handle->trace, entries, max);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Prints the trace of an instance as CSV (cycles,event,arg), oldest event first.
+ *
+ * @note  Starts with a "# dmx4esp trace" line holding the port and the cycles per µs,
+ *        bench/traceHistogram.py turns a captured log into per-stage latency histograms.
+ * @param handle The instance.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if tracing isn't compiled in, ESP_ERR_NO_MEM
+ */
+esp_err_t dmxTracePrint(dmx_handle_t handle){
+#if DMX_TRACE_ENABLED
+    dmxTraceEntry *entries = heap_caps_malloc(DMX_TRACE_ENTRIES * sizeof(dmxTraceEntry), MALLOC_CAP_DEFAULT);
+    if(entries == NULL){
+        printf("Memory allocation failed");
+        return ESP_ERR_NO_MEM;
+    }
+
+    size_t count = dmxTraceRead(&handle->trace, entries, DMX_TRACE_ENTRIES);
+    printf("# dmx4esp trace port=%d cycles_per_us=%d\n", handle->port, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ);
+    printf("cycles,event,arg\n");
+    for(size_t i = 0; i < count; i++){
+        printf("%" PRIu32 ",%s,%u\n", entries[i].cycles, dmxTraceEventName(entries[i].event), entries[i].arg);
+    }
+    heap_caps_free(entries);
+    return ESP_OK;
+#else
+    printf("DMX trace not compiled in, build with DMX_TRACE_ENABLED=1\n");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+/**
+ * @brief Internal function to check if the default instance is running.
+ *
+ * @note This function is only expected to be used internally.
+ * @return true if initDMX() was called successfully.
+ */
+static bool hasDefaultInstance(){
+    if(defaultInstance == NULL){
+        printf("DMX isn't initialized, call initDMX() first\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Clears the uart input buffer.
+ * @note  This function is only expected to be used internally.
+ * @return void
+ */
+void clearDMXQueue(){
+    if(hasDefaultInstance()){
+        uart_flush_input(defaultInstance->port);
+    }
+}
+
+/**
+ * @brief Sets the dmx data an instance sends.
+ *
+ * @note  The whole frame becomes visible at once with the next frame.
+ *        Never waits for a running transmission, the mutex only serializes concurrent full frame writes.
+ * @param handle The sending instance.
+ * @param data 512 bytes long array containing the dmx data to send
+ * @return void
+ */
+void dmxWrite(dmx_handle_t handle, const uint8_t data[]){
+    xSemaphoreTake(handle->writeMutex, portMAX_DELAY);
+    dmxTxFrameBeginBulk(&handle->frame);
+    dmxTxFrameWriteBulk(&handle->frame, 0, data, 512);
+    dmxTxFrameEndBulk(&handle->frame);
+    xSemaphoreGive(handle->writeMutex);
+    commitChange(handle);
+}
+
+/**
+ * @brief Changes the value of one dmx channel an instance sends.
+ *
+ * @note  Lock-free, safe to call at high rates from any number of tasks.
+ * @note  Between dmxBeginWrite() and dmxCommitWrite() it doesn't wake the send task (DMX_SEND_ON_CHANGE),
+ *        the commit sends the whole transaction in one frame.
+ * @param handle The sending instance.
+ * @param address The address of the dmx channel (1 - 512)
+ * @param value The dmx value to send (0 - 255)
+ * @return void
+ */
+void dmxWriteAddress(dmx_handle_t handle, uint16_t address, uint8_t value){
+    if(address >= 1 && address <= 512){
+        dmxTxFrameSetSlot(&handle->frame, address-1, value);
+        if(!dmxTxFrameInBulk(&handle->frame)){ //inside a transaction dmxCommitWrite() stamps and wakes the task once
+            commitChange(handle);
+        }
+    } else{
+        printf("Address out of scope (1 - 512): %i", address);
+    }
+}
+
+/**
+ * @brief Starts a transaction, all following dmxWriteAddress() calls become visible in the same frame.
+ *        Finish the transaction with dmxCommitWrite().
+ *
+ * @note  Frames sent during the transaction repeat the last committed data, so keep it short.
+ * @note  Don't call dmxWrite() or dmxBeginWrite() again before dmxCommitWrite(), the transaction isn't recursive.
+ * @param handle The sending instance.
+ * @return void
+ */
+void dmxBeginWrite(dmx_handle_t handle){
+    xSemaphoreTake(handle->writeMutex, portMAX_DELAY);
+    dmxTxFrameBeginBulk(&handle->frame);
+}
+
+/**
+ * @brief Publishes all changes since dmxBeginWrite() at once.
+ *
+ * @note  Costs one buffer publish, independent of the number of channels changed.
+ * @param handle The sending instance.
+ * @return void
+ */
+void dmxCommitWrite(dmx_handle_t handle){
+    dmxTxFrameEndBulk(&handle->frame);
+    xSemaphoreGive(handle->writeMutex);
+    commitChange(handle);
+}
+
+/**
+ * @brief Sets the number of frames an instance sends per second.
+ *
+ * @note  A full 512 channel frame takes ~23ms on the wire (max. 44Hz). Rates above that need a shorter frame
+ *        (see dmxConfigureSlotCount()), the rate is limited by the frame length (see dmxGetTransmitStats()).
+ * @param handle The sending instance.
+ * @param rate Refresh rate in Hz (1 - 830)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the rate is out of scope
+ */
+esp_err_t dmxConfigureRefreshRate(dmx_handle_t handle, uint16_t rate){
+    if(rate < 1 || rate > DMX_MAX_SHORT_FRAME_RATE){
+        printf("Refresh rate out of scope (1 - %i): %i", DMX_MAX_SHORT_FRAME_RATE, rate);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    handle->refreshRate = rate;
+    handle->avgIntervalUs = 0;
+    memset(&handle->refresh, 0, sizeof(handle->refresh));
+
+    return handle->frameTimer != NULL ? startFrameTimer(handle) : ESP_OK;
+}
+
+/**
+ * @brief Internal function to validate break and mark after break durations.
+ *
+ * @note This function is only expected to be used internally.
+ * @return true if both durations are within ANSI E1.11 limits.
+ */
+static bool isBreakTimingValid(uint32_t breakUs, uint32_t markUs){
+    if(breakUs < DMX_MIN_BREAK_US || breakUs >= DMX_MAX_BREAK_MARK_US || markUs < DMX_MIN_MARK_US || markUs >= DMX_MAX_BREAK_MARK_US){
+        printf("Break / mark after break out of scope (>= %ius / >= %ius, < 1s): %lu, %lu", DMX_MIN_BREAK_US, DMX_MIN_MARK_US, (unsigned long) breakUs, (unsigned long) markUs);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sets the duration of the break and mark after break signals an instance sends before every frame.
+ *
+ * @note  Limits according to ANSI E1.11 (transmitter): break >= 92µs, mark after break >= 12µs, both < 1s.
+ *        The break is ended by a timer callback (ESP_TIMER_ISR dispatch where available), so it's only a few µs longer.
+ *        The mark after break ends when the send task writes the frame, it's longer if another task of the same
+ *        priority keeps core 1 busy at that moment (up to one scheduler tick).
+ * @param handle The sending instance.
+ * @param breakUs Duration of the break in µs (default 250)
+ * @param markUs Duration of the mark after break in µs (default 20)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if a duration is out of scope
+ */
+esp_err_t dmxConfigureBreakTiming(dmx_handle_t handle, uint32_t breakUs, uint32_t markUs){
+    if(!isBreakTimingValid(breakUs, markUs)){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    handle->breakUs = breakUs; //picked up with the next frame
+    handle->markUs = markUs;
+    return handle->frameTimer != NULL ? startFrameTimer(handle) : ESP_OK; //the frame length changed
+}
+
+/**
+ * @brief Sets the number of slots an instance sends per frame.
+ *
+ * @note  Short frames take less time on the wire and allow refresh rates above 44Hz,
+ *        e.g. 24 slots -> up to ~730Hz with the default break timing. Slots above the count aren't sent.
+ * @param handle The sending instance.
+ * @param slotCount Number of slots per frame (24 - 512)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the slot count is out of scope
+ */
+esp_err_t dmxConfigureSlotCount(dmx_handle_t handle, uint16_t slotCount){
+    if(slotCount < DMX_MIN_SLOTS || slotCount > DMX_MAX_SLOTS){
+        printf("Slot count out of scope (%i - %i): %i", DMX_MIN_SLOTS, DMX_MAX_SLOTS, slotCount);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    handle->slotCount = slotCount; //picked up with the next frame
+    handle->avgIntervalUs = 0;
+    return handle->frameTimer != NULL ? startFrameTimer(handle) : ESP_OK;
+}
+
+/**
+ * @brief Selects when an instance starts a frame.
+ *
+ * @note  DMX_SEND_PERIODIC (default) sends on every refresh rate deadline.
+ *        DMX_SEND_ON_CHANGE starts a frame as soon as data is written (or right after the frame on the wire),
+ *        the refresh rate becomes the keepalive rate used while nothing changes.
+ * @param handle The sending instance.
+ * @param mode DMX_SEND_PERIODIC or DMX_SEND_ON_CHANGE
+ * @return ESP_OK on success
+ */
+esp_err_t dmxConfigureSendMode(dmx_handle_t handle, dmxSendMode mode){
+    handle->sendMode = mode;
+    handle->latencySumUs = 0;
+    memset(&handle->latency, 0, sizeof(handle->latency));
+    memset(&handle->refresh, 0, sizeof(handle->refresh));
+
+    return handle->frameTimer != NULL ? startFrameTimer(handle) : ESP_OK;
+}
+
+/**
+ * @brief Returns the target and achieved refresh rate of an instance.
+ *
+ * @param handle The sending instance.
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetTransmitStats(dmx_handle_t handle, dmxRefreshStats *stats){
+    uint32_t avgInterval = handle->avgIntervalUs;
+
+    *stats = handle->refresh;
+    stats->targetRate = handle->framePeriodUs > 0 ? 1000000.0f / handle->framePeriodUs : 0.0f;
+    stats->achievedRate = avgInterval > 0 ? 1000000.0f / avgInterval : 0.0f;
+}
+
+/**
+ * @brief Internal busy loop of dmxMeasureCpuLoad(), counts the cycles its core spends elsewhere.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs at idle priority pinned to one core. Every iteration that took longer than DMX_LOAD_PROBE_GAP_CYCLES
+ *       was interrupted or preempted, the whole gap counts as stolen.
+ * @param parameters The probe (struct dmxLoadProbe).
+ *
+ * @return void
+ */
+static void loadProbeTask(void *parameters){
+    struct dmxLoadProbe *probe = parameters;
+    esp_cpu_cycle_count_t last = esp_cpu_get_cycle_count();
+    uint64_t stolen = 0;
+    uint64_t total = 0;
+
+    while(!atomic_load_explicit(&probe->stop, memory_order_relaxed)){
+        esp_cpu_cycle_count_t now = esp_cpu_get_cycle_count();
+        uint32_t gap = now - last;
+        if(gap > DMX_LOAD_PROBE_GAP_CYCLES){
+            stolen += gap;
+        }
+        total += gap;
+        last = now;
+    }
+    probe->stolenCycles = stolen;
+    probe->totalCycles = total;
+    atomic_store(&probe->done, true);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Measures the CPU time a sending instance costs per frame, interrupts included.
+ *
+ * @note  A busy loop at idle priority runs on every core for durationMs and counts the cycles it doesn't get: the
+ *        send task, the FIFO refill interrupts of the UART driver or the DMA done interrupt, the timer interrupts,
+ *        but also the scheduler tick and anything else running meanwhile. Stop other work while measuring and
+ *        run it once per transmit mode (same slot count and rate) to compare them.
+ *        Unlike avgFrameCycles (dmxGetTransmitStats()) the figures of both modes are comparable.
+ * @note  Blocks the calling task for durationMs, the idle tasks only run every scheduler tick meanwhile.
+ * @param handle The sending instance.
+ * @param durationMs Length of the measurement (ms), a few hundred frames give a stable figure.
+ * @param load Pointer to the struct to fill.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if a probe task couldn't be created
+ */
+esp_err_t dmxMeasureCpuLoad(dmx_handle_t handle, uint32_t durationMs, dmxCpuLoad *load){
+    if(handle == NULL || load == NULL || durationMs == 0){
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(!handle->send){
+        printf("The CPU load is only measured for sending instances\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    struct dmxLoadProbe probes[portNUM_PROCESSORS] = {0};
+    int started = 0;
+    esp_err_t result = ESP_OK;
+    uint32_t framesBefore = handle->refresh.framesSent;
+    for(; started < portNUM_PROCESSORS; started++){
+        if(xTaskCreatePinnedToCore(loadProbeTask, "DMX Load Probe", 2048, &probes[started], tskIDLE_PRIORITY, NULL, started) != pdPASS){
+            printf("Failed to create the CPU load probe\n");
+            result = ESP_ERR_NO_MEM;
+            break;
+        }
+    }
+    if(result == ESP_OK){
+        vTaskDelay(pdMS_TO_TICKS(durationMs));
+    }
+    uint32_t frames = handle->refresh.framesSent - framesBefore;
+
+    uint64_t stolen = 0;
+    uint64_t total = 0;
+    for(int core = 0; core < started; core++){
+        atomic_store(&probes[core].stop, true);
+        while(!atomic_load(&probes[core].done)){
+            vTaskDelay(1);
+        }
+        stolen += probes[core].stolenCycles;
+        total += probes[core].totalCycles;
+    }
+    if(result != ESP_OK){
+        return result;
+    }
+
+    load->frames = frames;
+    load->cyclesPerFrame = frames > 0 ? (uint32_t) (stolen / frames) : 0;
+    load->busyPercent = total > 0 ? 100.0f * stolen / total : 0.0f;
+    return ESP_OK;
+}
+
+/**
+ * @brief Returns the distribution of the time from a write / commit to its first slot on the wire.
+ *
+ * @note  Measured in both send modes, reset by dmxConfigureSendMode().
+ * @param handle The sending instance.
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetLatencyStats(dmx_handle_t handle, dmxLatencyStats *stats){
+    *stats = handle->latency;
+}
+
+/**
+ * @brief Queues an alternate start code packet (e.g. 0x17 text, 0xCF SIP, 0x55 test, manufacturer codes) for sending.
+ *
+ * @note  The packet is copied. The send task sends it instead of a null start code frame on one of the next
+ *        deadlines, see dmxConfigureAlternateSchedule(). Never on a change triggered frame.
+ * @param handle The sending instance.
+ * @param packet [0] start code (not 0x00), [1 - ] slots.
+ * @param length Bytes in packet, start code included (2 - 513)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if DMX_ALTERNATE_QUEUE_LENGTH packets are waiting already
+ */
+esp_err_t dmxQueueAlternate(dmx_handle_t handle, const uint8_t *packet, uint16_t length){
+    if(handle == NULL || packet == NULL || length < 2 || length > 513 || packet[0] == DMX_START_CODE_NULL){
+        printf("Alternate packet out of scope (start code != 0x00, 2 - 513 bytes): %i\n", length);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(!handle->send){
+        printf("Alternate packets are only sent by sending instances\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    struct dmxAlternateFrame frame = {.length = length};
+    memcpy(frame.packet, packet, length);
+    if(xQueueSend(handle->alternateQueue, &frame, 0) != pdTRUE){
+        atomic_fetch_add_explicit(&handle->alternateQueueFull, 1, memory_order_relaxed);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Sets how alternate start code packets are interleaved with null start code frames.
+ *
+ * @note  An alternate frame replaces a null frame. At least interleave null frames go out between two alternate frames,
+ *        and an alternate frame is held back if the next null frame would start later than 1 / minNullRate after the previous one.
+ * @param handle The sending instance.
+ * @param interleave Null frames between two alternate frames (1 - 255), 0 -> DMX_DEFAULT_ALTERNATE_INTERLEAVE
+ * @param minNullRate Floor of the null frame rate in Hz (0 - 830), 0 -> no floor
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the floor is out of scope
+ */
+esp_err_t dmxConfigureAlternateSchedule(dmx_handle_t handle, uint8_t interleave, uint16_t minNullRate){
+    if(minNullRate > DMX_MAX_SHORT_FRAME_RATE){
+        printf("Null frame rate floor out of scope (0 - %i): %i", DMX_MAX_SHORT_FRAME_RATE, minNullRate);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    handle->alternateInterleave = interleave != 0 ? interleave : DMX_DEFAULT_ALTERNATE_INTERLEAVE; //picked up with the next frame
+    handle->minNullRate = minNullRate;
+    return ESP_OK;
+}
+
+/**
+ * @brief Returns the number of frames an instance sent per start code.
+ *
+ * @param handle The sending instance.
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetAlternateStats(dmx_handle_t handle, dmxAlternateStats *stats){
+    *stats = handle->alternateStats;
+    stats->queueFull = atomic_load_explicit(&handle->alternateQueueFull, memory_order_relaxed);
+}
+
+/**
+ * @brief Takes a reference on the latest frame an instance received. The frame doesn't change until it's released.
+ *
+ * @note  Never blocks and never copies, the decoder keeps receiving into the other buffers.
+ *        Release every frame with dmxReleaseFrame() after use.
+ * @param handle The receiving instance.
+ * @return the latest frame: packet[n] holds channel n, sequence increments per frame, timestamp in µs.
+ *         sequence is 0 if nothing was received yet.
+ */
+const dmxRxFrame* dmxAcquireFrame(dmx_handle_t handle){
+    return dmxRxBufferAcquire(&handle->rxBuffer);
+}
+
+/**
+ * @brief Releases a frame taken with dmxAcquireFrame().
+ *
+ * @param handle The receiving instance.
+ * @param frame The frame to release.
+ * @return void
+ */
+void dmxReleaseFrame(dmx_handle_t handle, const dmxRxFrame *frame){
+    dmxRxBufferRelease(&handle->rxBuffer, frame);
+}
+
+/**
+ * @brief Retuns the dmx data an instance received.
+ *
+ * @note  Points into the latest complete frame without holding it. Once newer frames arrive the buffer is reused, so the
+ *        data can change at any time while it's read. Use dmxAcquireFrame() / dmxReleaseFrame() for a stable frame.
+ * @param handle The receiving instance.
+ * @return pointer to the 512 channels received, [0] is channel 1.
+ */
+uint8_t* dmxRead(dmx_handle_t handle){
+    return (uint8_t*) &dmxRxBufferLatest(&handle->rxBuffer)->packet[1];
+}
+
+/**
+ * @brief Retuns one dmx channel an instance received.
+ *
+ * @param handle The receiving instance.
+ * @param address The address of the dmx channel to read from (1 - 512)
+ * @return data of the dmx channel (0 - 255)
+ */
+uint8_t dmxReadAddress(dmx_handle_t handle, uint16_t address){
+    if(address >= 1 && address <= 512){
+        return dmxRxBufferLatest(&handle->rxBuffer)->packet[address];
+    } else{
+        printf("Address out of scope (1 - 512): %i", address);
+        return 0;
+    }
+}
+
+/**
+ * @brief Internal function to validate the address range of a fixture.
+ *
+ * @note This function is only expected to be used internally.
+ * @return true if startAddress - startAddress + footprint - 1 is within 1 - 512.
+ */
+static bool isFixtureRangeValid(uint16_t startAddress, uint16_t footprint){
+    if(footprint < 1 || footprint > 512){
+        printf("Footprint out of scope (1 - 512): %i", footprint);
+        return false;
+    }
+    if(startAddress < 1 || startAddress + footprint > 513){
+        printf("startAddress out of scope (1 - 512) / footprint exeeds scope: %i, footprint: %i, lastAddress: %i", startAddress, footprint, startAddress + footprint -1);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Retuns a range of the dmx data an instance received.
+ *
+ * @note please make sure that the startAddress and footprint don't exceed the maximum of channels! (512)
+ * @note all channels are copied from the same frame.
+ * @note allocates on every call, use dmxReadFixtureInto() or a dmxFixtureView in loops.
+ * @param handle The receiving instance.
+ * @param startAddress The first address to read from (1 - 512)
+ * @param footprint number of channels needed to read from (1 - 512)
+ * @return data of the dmx channels. IMPORTANT! free memory after use!
+ */
+uint8_t* dmxReadFixture(dmx_handle_t handle, uint16_t startAddress, uint16_t footprint){
+    if(!isFixtureRangeValid(startAddress, footprint)){
+        return NULL;
+    }
+
+    uint8_t* fixtureData = (uint8_t*) malloc(footprint); //dynamic allocation to the heap. CALLER HAS TO FREE MEMORY AFTER USE!
+    if(fixtureData == NULL){
+        printf("Memory allocation failed");
+        return NULL;
+    }
+
+    const dmxRxFrame *frame = dmxAcquireFrame(handle);
+    memcpy(fixtureData, &frame->packet[startAddress], footprint); //copy a part of the original dmx output
+    dmxReleaseFrame(handle, frame);
+
+    return fixtureData;
+}
+
+/**
+ * @brief Copies a range of the dmx data an instance received into caller owned memory.
+ *
+ * @note  No heap and no lock: all channels are copied from one referenced frame.
+ * @param handle The receiving instance.
+ * @param startAddress The first address to read from (1 - 512)
+ * @param footprint number of channels needed to read from (1 - 512)
+ * @param destination At least footprint bytes, destination[0] receives startAddress.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the range is out of scope
+ */
+esp_err_t dmxReadFixtureInto(dmx_handle_t handle, uint16_t startAddress, uint16_t footprint, uint8_t *destination){
+    if(destination == NULL || !isFixtureRangeValid(startAddress, footprint)){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const dmxRxFrame *frame = dmxAcquireFrame(handle);
+    memcpy(destination, &frame->packet[startAddress], footprint);
+    dmxReleaseFrame(handle, frame);
+    return ESP_OK;
+}
+
+/**
+ * @brief Sets up a fixture view on caller owned storage, update it with dmxFixtureViewUpdate().
+ *
+ * @note  The storage is cleared, the view doesn't allocate.
+ * @param view The view to set up.
+ * @param startAddress The first address of the fixture (1 - 512)
+ * @param footprint number of channels of the fixture (1 - 512)
+ * @param storage At least footprint bytes, owned by the caller for the lifetime of the view.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the range is out of scope
+ */
+esp_err_t dmxFixtureViewInit(dmxFixtureView *view, uint16_t startAddress, uint16_t footprint, uint8_t *storage){
+    if(view == NULL || storage == NULL || !isFixtureRangeValid(startAddress, footprint)){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    view->startAddress = startAddress;
+    view->footprint = footprint;
+    view->data = storage;
+    view->sequence = 0;
+    memset(storage, 0, footprint);
+    return ESP_OK;
+}
+
+/**
+ * @brief Copies the footprint of a fixture view out of the latest received frame.
+ *
+ * @note  No heap and no lock. Nothing is copied if no new frame arrived, or if the next frame
+ *        didn't change a channel of the fixture (see dmxRxFrame.changes).
+ * @param handle The receiving instance.
+ * @param view A view set up with dmxFixtureViewInit().
+ * @return true if view->data changed
+ */
+bool dmxFixtureViewUpdate(dmx_handle_t handle, dmxFixtureView *view){
+    const dmxRxFrame *frame = dmxAcquireFrame(handle);
+    uint16_t last = view->startAddress + view->footprint - 1;
+    bool changed = false;
+
+    if(frame->sequence != view->sequence){
+        //frame->changes only covers the step from the previous frame, after a gap the data is compared
+        if(frame->sequence == view->sequence + 1){
+            changed = dmxDirtyAny(&frame->changes, view->startAddress, last);
+        } else{
+            changed = memcmp(view->data, &frame->packet[view->startAddress], view->footprint) != 0;
+        }
+        if(changed){
+            memcpy(view->data, &frame->packet[view->startAddress], view->footprint);
+        }
+        view->sequence = frame->sequence;
+    }
+
+    dmxReleaseFrame(handle, frame);
+    return changed;
+}
+
+/**
+ * @brief Selects what receivers see once the input signal of an instance is lost.
+ *
+ * @note  The signal counts as lost if no valid frame arrived for timeoutMs (framing errors don't count as frames).
+ *        DMX_LOSS_HOLD keeps the last frame, DMX_LOSS_BLACKOUT publishes zeros immediately,
+ *        DMX_LOSS_FADE holds the last frame for holdMs and fades it to zero over fadeMs (one step per 20ms tick).
+ *        The next valid frame restores live data at once. The callback runs in the esp_timer task.
+ * @param handle The receiving instance.
+ * @param config Policy, timings and optional callback.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxConfigureSignalLoss(dmx_handle_t handle, const dmxSignalLossConfig *config){
+    if(handle == NULL || config == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(handle->send){
+        printf("Loss of signal is only detected by receiving instances\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    portENTER_CRITICAL(&handle->rxLock);
+    handle->signalLoss = *config;
+    handle->signal.policy = config->policy;
+    handle->signal.timeoutUs = (int64_t) (config->timeoutMs != 0 ? config->timeoutMs : DMX_DEFAULT_LOSS_TIMEOUT_MS) * 1000;
+    handle->signal.holdUs = (int64_t) config->holdMs * 1000;
+    handle->signal.fadeUs = (int64_t) config->fadeMs * 1000;
+    portEXIT_CRITICAL(&handle->rxLock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Returns whether an instance receives a signal, and the output level while it's lost.
+ *
+ * @param handle The receiving instance.
+ * @param status Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetSignalStatus(dmx_handle_t handle, dmxSignalStatus *status){
+    portENTER_CRITICAL(&handle->rxLock);
+    dmxSignalMonitor signal = handle->signal;
+    portEXIT_CRITICAL(&handle->rxLock);
+
+    status->state = signal.state;
+    status->msSinceFrame = signal.lastFrameUs != 0 ? (esp_timer_get_time() - signal.lastFrameUs) / 1000 : 0;
+    status->level = signal.level;
+    status->losses = signal.losses;
+}
+
+/**
+ * @brief Registers the handler of an alternate start code (e.g. 0x17 text, 0xCF SIP, 0x55 test, manufacturer codes).
+ *
+ * @note  Frames with a start code other than 0x00 never overwrite the dimmer frames. They're decoded into a
+ *        separate packet and handed to their handler from the UART interrupt, keep it short and copy what you need.
+ *        No library lock is held during the call. Once this returns, a replaced or removed handler isn't running
+ *        anymore (it waits for a running call), so never call it from a handler.
+ *        SIPs are only handed over with a valid checksum, test packets only if intact (see dmxParseSip(), dmxParseText()).
+ * @param handle The receiving instance.
+ * @param startCode Start code to handle (0x01 - 0xFF).
+ * @param handler Called for every frame with that start code, NULL removes the handler.
+ * @param context Passed to the handler.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if DMX_MAX_START_CODE_HANDLERS are registered already
+ */
+esp_err_t dmxSetStartCodeHandler(dmx_handle_t handle, uint8_t startCode, dmxStartCodeHandler handler, void *context){
+    if(handle == NULL || startCode == DMX_START_CODE_NULL){
+        printf("Null start code frames are read with dmxAcquireFrame() / dmxSubscribe()\n");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(handle->send){
+        printf("Start code handlers are only called by receiving instances\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t result = handler == NULL ? ESP_OK : ESP_ERR_NO_MEM;
+    struct dmxStartCodeEntry *slot = NULL;
+    portENTER_CRITICAL(&handle->rxLock);
+    for(int i = 0; i < DMX_MAX_START_CODE_HANDLERS; i++){
+        struct dmxStartCodeEntry *entry = &handle->startCodeHandlers[i];
+        if(entry->active && entry->startCode == startCode){
+            entry->active = false; //replaced or removed
+        }
+        if(!entry->active && slot == NULL){
+            slot = entry;
+        }
+    }
+    if(handler != NULL && slot != NULL){
+        *slot = (struct dmxStartCodeEntry) {.active = true, .startCode = startCode, .handler = handler, .context = context};
+        result = ESP_OK;
+    }
+    portEXIT_CRITICAL(&handle->rxLock);
+
+    for(;;){ //the interrupt may be calling the previous handler right now
+        portENTER_CRITICAL(&handle->rxLock);
+        bool dispatching = handle->alternateDispatching;
+        portEXIT_CRITICAL(&handle->rxLock);
+        if(!dispatching){
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    if(result != ESP_OK){
+        printf("No free start code handler slot (max %i)\n", DMX_MAX_START_CODE_HANDLERS);
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the number of frames an instance received per start code, and length and start code of the last frame.
+ *
+ * @param handle The receiving instance.
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetStartCodeStats(dmx_handle_t handle, dmxStartCodeStats *stats){
+    portENTER_CRITICAL(&handle->rxLock);
+    *stats = handle->startCodeStats;
+    portEXIT_CRITICAL(&handle->rxLock);
+}
+
+/**
+ * @brief Subscribes to frame-received notifications of a receiving instance.
+ *
+ * @note  Sent when a frame is published, by the UART interrupt or (fade / blackout frames) the esp_timer task,
+ *        consumers don't have to poll.
+ *        With a range, only frames where a slot in firstAddress - lastAddress differs from the previous frame notify.
+ * @note  DMX_NOTIFY_BY_TASK overwrites the notification value with the frame sequence, wait with xTaskNotifyWait().
+ *        A task that is behind wakes once for the latest frame instead of once per missed frame.
+ * @param handle The receiving instance.
+ * @param config Target (task, queue or callback) and optional address range.
+ * @param subscription Pointer to the handle of the subscription, may be NULL if it's never removed.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if DMX_MAX_SUBSCRIBERS are subscribed already
+ */
+esp_err_t dmxSubscribe(dmx_handle_t handle, const dmxSubscribeConfig *config, dmx_subscription_t *subscription){
+    if(handle == NULL || config == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(handle->send){
+        printf("Frame notifications are only sent by receiving instances\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if((config->type == DMX_NOTIFY_BY_TASK && config->task == NULL) || (config->type == DMX_NOTIFY_BY_QUEUE && config->queue == NULL)
+       || (config->type == DMX_NOTIFY_BY_CALLBACK && config->callback == NULL)){
+        printf("No notification target present for type %i\n", config->type);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if((config->firstAddress != 0 || config->lastAddress != 0)
+       && (config->firstAddress < 1 || config->lastAddress > 512 || config->firstAddress > config->lastAddress)){
+        printf("Address range out of scope (1 - 512): %i - %i\n", config->firstAddress, config->lastAddress);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t result = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&handle->subscriberLock);
+    for(int i = 0; i < DMX_MAX_SUBSCRIBERS; i++){
+        struct dmxSubscriber *subscriber = &handle->subscribers[i];
+        if(!subscriber->active){
+            subscriber->config = *config;
+            subscriber->active = true;
+            if(subscription != NULL){
+                *subscription = subscriber;
+            }
+            result = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&handle->subscriberLock);
+
+    if(result != ESP_OK){
+        printf("No free subscriber slot (max %i)\n", DMX_MAX_SUBSCRIBERS);
+    }
+    return result;
+}
+
+/**
+ * @brief Removes a subscription, its target isn't notified anymore once this returns.
+ *
+ * @note  Waits for notifications that were already on their way (a callback still running), so never call it
+ *        from a subscriber callback.
+ * @param handle The receiving instance.
+ * @param subscription The subscription to remove, the handle is invalid afterwards.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxUnsubscribe(dmx_handle_t handle, dmx_subscription_t subscription){
+    if(handle == NULL || subscription < &handle->subscribers[0] || subscription >= &handle->subscribers[DMX_MAX_SUBSCRIBERS]){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&handle->subscriberLock);
+    subscription->active = false;
+    bool dispatching = handle->dispatching != 0;
+    portEXIT_CRITICAL(&handle->subscriberLock);
+
+    while(dispatching){
+        vTaskDelay(1);
+        portENTER_CRITICAL(&handle->subscriberLock);
+        dispatching = handle->dispatching != 0;
+        portEXIT_CRITICAL(&handle->subscriberLock);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Internal subscriber of dmxSelfTest(), checks every received frame against the pattern it carries.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Runs in the UART interrupt of the receiver, or in the esp_timer task for frames of a lost signal.
+ * @param handle The receiving instance.
+ * @param frame The frame just published.
+ * @param context The running test (struct dmxSelfTestRun).
+ *
+ * @return void
+ */
+static void checkSelfTestFrame(dmx_handle_t handle, const dmxRxFrame *frame, void *context){
+    struct dmxSelfTestRun *run = context;
+    const uint8_t *slots = &frame->packet[1];
+    uint16_t received = frame->length > 0 ? frame->length - 1 : 0;
+    uint8_t number = 0;
+    bool numbered = dmxSelfTestNumber(slots, received, &number);
+    bool arrived = false;
+
+    //both counters are read at the same point of a frame, so a frame the sender just started cancels out
+    uint32_t sent = run->sender->alternateStats.nullFrames;
+    uint32_t published = handle->decoder.stats.frames - handle->rxBuffer.dropped;
+    portENTER_CRITICAL_ISR(&run->lock);
+    if(!run->locked && numbered && number == run->number){
+        run->locked = true;
+        run->sentFirst = sent;
+        run->receivedFirst = published;
+    }
+    if(run->locked){
+        //frames carry the previous pattern until the sender picked up the current one
+        uint8_t reference = numbered && number == (uint8_t) (run->number - 1) ? number : run->number;
+        run->slotErrors += dmxSelfTestCompare(slots, received, run->slotCount, reference);
+        run->slotsChecked += run->slotCount;
+        run->framesChecked++;
+        run->sentLast = sent;
+        run->receivedLast = published;
+
+        if(!run->arrived && numbered && number == run->number){
+            run->arrived = arrived = true;
+            run->latencies[run->latencyCount++] = (uint32_t) (frame->timestamp - run->commitUs);
+        }
+    }
+    portEXIT_CRITICAL_ISR(&run->lock);
+
+    if(arrived){
+        xTaskNotifyFromISR(run->task, DMX_NOTIFY_SELF_TEST, eSetBits, NULL);
+    }
+}
+
+/**
+ * @brief Internal function waiting until the current pattern of a self test arrived.
+ *
+ * @note This function is only expected to be used internally.
+ * @param receiver The receiving instance.
+ * @param run The running test.
+ * @param deadline Time to give up (µs, esp_timer).
+ *
+ * @return true if the pattern arrived before the deadline
+ */
+static bool waitForSelfTestPattern(dmx_handle_t receiver, struct dmxSelfTestRun *run, int64_t deadline){
+    for(;;){
+        portENTER_CRITICAL(&run->lock);
+        bool arrived = run->arrived;
+        portEXIT_CRITICAL(&run->lock);
+
+        int64_t left = deadline - esp_timer_get_time();
+        if(arrived || left <= 0){
+            return arrived;
+        }
+        xTaskNotifyWait(0, DMX_NOTIFY_SELF_TEST, NULL, pdMS_TO_TICKS(left / 1000) + 1);
+    }
+}
+
+/**
+ * @brief Checks a link end to end: one instance sends test patterns, another one receives them (same chip, looped back
+ *        UART, or a transceiver and cable in between). Blocks until every pattern arrived or timed out.
+ *
+ * @note  The patterns (see dmxPattern) are sent one at a time, the next one once the previous one arrived. Every frame the
+ *        receiver publishes meanwhile is compared slot by slot. Latencies are commit (dmxWrite()) to frame complete at
+ *        the receiver, so they include the wait for the next frame deadline of the sender.
+ *        With testPacketInterval, 0x55 network test packets are queued as well (dmxQueueAlternate()).
+ * @note  Uses bit 31 of the calling task's notification value. The sender keeps sending the last pattern afterwards,
+ *        write your own data again. Frames the receiver dropped because readers held its buffers count as dropped.
+ * @param sender The sending instance, in its configured send mode, refresh rate and slot count.
+ * @param receiver The receiving instance.
+ * @param config Number of patterns, test packet interval and timeout, NULL -> defaults.
+ * @param result Pointer to the struct to fill.
+ * @return ESP_OK once the test ran, ESP_ERR_TIMEOUT if no pattern arrived at all
+ */
+esp_err_t dmxSelfTest(dmx_handle_t sender, dmx_handle_t receiver, const dmxSelfTestConfig *config, dmxSelfTestResult *result){
+    if(sender == NULL || receiver == NULL || result == NULL || !sender->send || receiver->send){
+        printf("Self test needs a sending and a receiving instance\n");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmxSelfTestConfig options = config != NULL ? *config : (dmxSelfTestConfig) {0};
+    uint16_t patterns = options.patterns != 0 ? options.patterns : DMX_SELF_TEST_DEFAULT_PATTERNS;
+    int64_t timeoutUs = options.timeoutMs != 0 ? (int64_t) options.timeoutMs * 1000 : 3 * (int64_t) sender->framePeriodUs + 10000;
+
+    struct dmxSelfTestRun run = {.sender = sender, .task = xTaskGetCurrentTaskHandle(), .slotCount = sender->slotCount};
+    portMUX_INITIALIZE(&run.lock);
+    run.latencies = heap_caps_malloc(patterns * sizeof(uint32_t), MALLOC_CAP_DEFAULT);
+    if(run.latencies == NULL){
+        return ESP_ERR_NO_MEM;
+    }
+    dmxSubscribeConfig subscribe = {.type = DMX_NOTIFY_BY_CALLBACK, .callback = checkSelfTestFrame, .context = &run};
+    dmx_subscription_t subscription;
+    esp_err_t error = dmxSubscribe(receiver, &subscribe, &subscription);
+    if(error != ESP_OK){
+        heap_caps_free(run.latencies);
+        return error;
+    }
+
+    dmxStats before;
+    dmxStartCodeStats codesBefore;
+    dmxGetStats(receiver, &before);
+    dmxGetStartCodeStats(receiver, &codesBefore);
+    memset(result, 0, sizeof(*result));
+
+    uint8_t testPacket[513];
+    uint8_t data[512] = {0};
+    memset(testPacket, DMX_TEST_SLOT_VALUE, sizeof(testPacket));
+    testPacket[0] = DMX_START_CODE_TEST;
+
+    for(uint16_t i = 0; i < patterns; i++){
+        if(options.testPacketInterval != 0 && i % options.testPacketInterval == 0
+           && dmxQueueAlternate(sender, testPacket, sizeof(testPacket)) == ESP_OK){
+            result->testPacketsSent++;
+        }
+        dmxSelfTestFill(data, sizeof(data), (uint8_t) i);
+
+        portENTER_CRITICAL(&run.lock);
+        run.number = (uint8_t) i;
+        run.arrived = false;
+        run.commitUs = esp_timer_get_time();
+        portEXIT_CRITICAL(&run.lock);
+
+        dmxWrite(sender, data);
+        result->patterns++;
+        result->patternsReceived += waitForSelfTestPattern(receiver, &run, run.commitUs + timeoutUs);
+    }
+
+    //queued test packets go out on the next deadlines, after alternateInterleave null frames each
+    dmxStartCodeStats codes;
+    int64_t drainEnd = esp_timer_get_time() + timeoutUs
+                       + (int64_t) DMX_ALTERNATE_QUEUE_LENGTH * (sender->alternateInterleave + 1) * sender->framePeriodUs;
+    do{
+        dmxGetStartCodeStats(receiver, &codes);
+        if(codes.testPackets + codes.testErrors - codesBefore.testPackets - codesBefore.testErrors >= result->testPacketsSent){
+            break;
+        }
+        vTaskDelay(1);
+    } while(esp_timer_get_time() < drainEnd);
+    dmxUnsubscribe(receiver, subscription);
+
+    dmxStats after;
+    dmxGetStats(receiver, &after);
+    portENTER_CRITICAL(&run.lock);
+    result->framesSent = run.sentLast - run.sentFirst;
+    result->framesReceived = run.receivedLast - run.receivedFirst;
+    result->framesChecked = run.framesChecked;
+    result->slotsChecked = run.slotsChecked;
+    result->slotErrors = run.slotErrors;
+    portEXIT_CRITICAL(&run.lock);
+
+    result->framesDropped = result->framesSent > result->framesReceived ? result->framesSent - result->framesReceived : 0;
+    result->slotErrorRate = result->slotsChecked > 0 ? (float) result->slotErrors / result->slotsChecked : 0.0f;
+    result->lineErrors = (after.frameErrors - before.frameErrors) + (after.parityErrors - before.parityErrors)
+                         + (after.fifoOverflows - before.fifoOverflows);
+    result->testPacketsReceived = codes.testPackets - codesBefore.testPackets;
+    result->testPacketErrors = codes.testErrors - codesBefore.testErrors;
+    dmxSelfTestLatencies(run.latencies, run.latencyCount, result);
+    heap_caps_free(run.latencies);
+
+    return result->patternsReceived > 0 ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+/**
+ * @brief This function only sets the dmx data to send!
+ **       The actual data transfer happens in the init() function.
+ * @note  init() sends the dmxSignal concurrently!
+ * @note  The whole frame becomes visible at once with the next frame.
+ *        Never waits for a running transmission, the mutex only serializes concurrent sendDMX() calls.
+ * @param DMXStream 512 bytes long array containing the dmx data to send
+ * @return void
+ */
+void sendDMX(uint8_t DMXStream[]){
+    if(hasDefaultInstance()){
+        dmxWrite(defaultInstance, DMXStream);
+    }
+}
+
+/**
+ * @brief Changes the value of any given dmx channel.
+ *        This function only sets the data to send!
+ * @note  init() sends the dmxSignal concurrently!
+ * @note  Lock-free, safe to call at high rates from any number of tasks.
+ *
+ * @param address The address of the dmx channel (1 - 512)
+ * @param value The dmx value to send (0 - 255)
+ * @return void
+ */
+void sendAddress(uint16_t address, uint8_t value){
+    if(hasDefaultInstance()){
+        dmxWriteAddress(defaultInstance, address, value);
+    }
+}
+
+/**
+ * @brief Sets the number of frames sent per second.
+ *
+ * @note  Can be called before or after initDMX(). A full 512 channel frame takes ~23ms on the wire (max. 44Hz),
+ *        higher rates need a shorter frame (see dmxSetSlotCount()). The rate is limited by the frame length (see dmxGetRefreshStats()).
+ * @param rate Refresh rate in Hz (1 - 830)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the rate is out of scope
+ */
+esp_err_t dmxSetRefreshRate(uint16_t rate){
+    if(rate < 1 || rate > DMX_MAX_SHORT_FRAME_RATE){
+        printf("Refresh rate out of scope (1 - %i): %i", DMX_MAX_SHORT_FRAME_RATE, rate);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    defaultConfig.refreshRate = rate;
+    return defaultInstance != NULL ? dmxConfigureRefreshRate(defaultInstance, rate) : ESP_OK;
+}
+
+/**
+ * @brief Sets the number of slots sent per frame.
+ *
+ * @note  Can be called before or after initDMX(). Short frames allow refresh rates above 44Hz.
+ * @param slotCount Number of slots per frame (24 - 512)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the slot count is out of scope
+ */
+esp_err_t dmxSetSlotCount(uint16_t slotCount){
+    if(slotCount < DMX_MIN_SLOTS || slotCount > DMX_MAX_SLOTS){
+        printf("Slot count out of scope (%i - %i): %i", DMX_MIN_SLOTS, DMX_MAX_SLOTS, slotCount);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    defaultConfig.slotCount = slotCount;
+    return defaultInstance != NULL ? dmxConfigureSlotCount(defaultInstance, slotCount) : ESP_OK;
+}
+
+/**
+ * @brief Selects when frames are sent, periodic or as soon as something changes.
+ *
+ * @note  Can be called before or after initDMX(). In DMX_SEND_ON_CHANGE the refresh rate
+ *        (dmxSetRefreshRate()) is the keepalive rate used while nothing changes.
+ * @param mode DMX_SEND_PERIODIC or DMX_SEND_ON_CHANGE
+ * @return ESP_OK on success
+ */
+esp_err_t dmxSetSendMode(dmxSendMode mode){
+    defaultConfig.sendMode = mode;
+    return defaultInstance != NULL ? dmxConfigureSendMode(defaultInstance, mode) : ESP_OK;
+}
+
+/**
+ * @brief Sets the duration of the break and mark after break signals sent before every frame.
+ *
+ * @note  Limits according to ANSI E1.11 (transmitter): break >= 92µs, mark after break >= 12µs, both < 1s.
+ *        The break is ended by a timer callback (ESP_TIMER_ISR dispatch where available), so it's only a few µs longer.
+ *        The mark after break ends when the send task writes the frame, it's longer if another task of the same
+ *        priority keeps core 1 busy at that moment (up to one scheduler tick).
+ * @param breakUs Duration of the break in µs (default 250)
+ * @param markUs Duration of the mark after break in µs (default 20)
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if a duration is out of scope
+ */
+esp_err_t dmxSetBreakTiming(uint32_t breakUs, uint32_t markUs){
+    if(!isBreakTimingValid(breakUs, markUs)){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    defaultConfig.breakUs = breakUs;
+    defaultConfig.markUs = markUs;
+    return defaultInstance != NULL ? dmxConfigureBreakTiming(defaultInstance, breakUs, markUs) : ESP_OK;
+}
+
+/**
+ * @brief Selects how frames are handed to the UART. Has to be called before initDMX().
+ *
+ * @note  DMX_TX_DRIVER (default) copies every frame into the UART driver's ring buffer.
+ *        DMX_TX_DMA streams the frame directly from memory via UHCI/GDMA, without a copy
+ *        or FIFO refill interrupts. Only available on chips with UHCI (e.g. esp32-s3, esp32-c3) and ESP-IDF >= 5.5.
+ * @param mode DMX_TX_DRIVER or DMX_TX_DMA
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if DMA isn't available on this chip
+ */
+esp_err_t dmxSetTransmitMode(dmxTransmitMode mode){
+    if(mode == DMX_TX_DMA && !DMX_DMA_SUPPORTED){
+        printf("DMA transmit mode isn't supported on this chip\n");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if(defaultInstance != NULL){
+        printf("Transmit mode has to be selected before initDMX()\n");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    defaultConfig.transmitMode = mode;
+    return ESP_OK;
+}
+
+/**
+ * @brief Sets how alternate start code packets are interleaved with null start code frames.
+ *
+ * @note  Can be called before or after initDMX(true), see dmxConfigureAlternateSchedule().
+ * @param interleave Null frames between two alternate frames (1 - 255), 0 -> DMX_DEFAULT_ALTERNATE_INTERLEAVE
+ * @param minNullRate Floor of the null frame rate in Hz (0 - 830), 0 -> no floor
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the floor is out of scope
+ */
+esp_err_t dmxSetAlternateSchedule(uint8_t interleave, uint16_t minNullRate){
+    if(minNullRate > DMX_MAX_SHORT_FRAME_RATE){
+        printf("Null frame rate floor out of scope (0 - %i): %i", DMX_MAX_SHORT_FRAME_RATE, minNullRate);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    defaultConfig.alternateInterleave = interleave;
+    defaultConfig.minNullRate = minNullRate;
+    return defaultInstance != NULL ? dmxConfigureAlternateSchedule(defaultInstance, interleave, minNullRate) : ESP_OK;
+}
+
+/**
+ * @brief Queues an alternate start code packet, it's sent between the regular frames.
+ *
+ * @note  init() sends the dmxSignal concurrently! See dmxQueueAlternate().
+ * @param packet [0] start code (not 0x00), [1 - ] slots.
+ * @param length Bytes in packet, start code included (2 - 513)
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the queue is full
+ */
+esp_err_t sendAlternate(const uint8_t *packet, uint16_t length){
+    return hasDefaultInstance() ? dmxQueueAlternate(defaultInstance, packet, length) : ESP_ERR_INVALID_STATE;
+}
+
+/**
+ * @brief Selects what receivers see once the input signal is lost.
+ *
+ * @note  Can be called before or after initDMX(false), see dmxConfigureSignalLoss().
+ * @param config Policy, timings and optional callback.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxSetSignalLoss(const dmxSignalLossConfig *config){
+    if(config == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    defaultConfig.signalLoss = *config;
+    return defaultInstance != NULL && !defaultInstance->send ? dmxConfigureSignalLoss(defaultInstance, config) : ESP_OK;
+}
+
+/**
+ * @brief Returns the target and achieved refresh rate of the send task.
+ *
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxGetRefreshStats(dmxRefreshStats *stats){
+    if(hasDefaultInstance()){
+        dmxGetTransmitStats(defaultInstance, stats);
+    } else{
+        memset(stats, 0, sizeof(*stats));
+    }
+}
+
+/**
+ * @brief Starts a transaction, all following sendAddress() calls become visible in the same frame.
+ *        Finish the transaction with dmxCommit().
+ *
+ * @note  Frames sent during the transaction repeat the last committed data, so keep it short.
+ * @note  Don't call sendDMX() or dmxBegin() again before dmxCommit(), the transaction isn't recursive.
+ * @return void
+ */
+void dmxBegin(){
+    if(hasDefaultInstance()){
+        dmxBeginWrite(defaultInstance);
+    }
+}
+
+/**
+ * @brief Publishes all changes since dmxBegin() at once.
+ *
+ * @note  Costs one buffer publish, independent of the number of channels changed.
+ * @return void
+ */
+void dmxCommit(){
+    if(hasDefaultInstance()){
+        dmxCommitWrite(defaultInstance);
+    }
+}
+
+/**
+ * @brief Retuns a received dmx signal (once).
+ *
+ * @note  init() reads the dmxSignal concurrently!
+ * @note  The frame isn't held, the buffer is reused for newer frames and can change while it's read.
+ *        Use readDMXFrame() / releaseDMXFrame() for a stable frame.
+ *
+ * @return dmxOutput - pointer to the 512 channels received, [0] is channel 1.
+ */
+uint8_t* readDMX(){
+    return hasDefaultInstance() ? dmxRead(defaultInstance) : NULL;
+}
+
+/**
+ * @brief Takes a reference on the latest received frame, it doesn't change until releaseDMXFrame().
+ *
+ * @note  Tear-free and without copying, release every frame after use.
+ *
+ * @return frame - packet[n] holds channel n, plus sequence number and receive timestamp (µs). NULL if not initialized.
+ */
+const dmxRxFrame* readDMXFrame(){
+    return hasDefaultInstance() ? dmxAcquireFrame(defaultInstance) : NULL;
+}
+
+/**
+ * @brief Releases a frame taken with readDMXFrame().
+ *
+ * @param frame The frame to release.
+ * @return void
+ */
+void releaseDMXFrame(const dmxRxFrame *frame){
+    if(hasDefaultInstance() && frame != NULL){
+        dmxReleaseFrame(defaultInstance, frame);
+    }
+}
+
+/**
+ * @brief Retuns a received dmx channel (once).
+ *
+ * @note  init() reads the dmxSignal concurrently!
+ * @param address The address of the dmx channel to read from (1 - 512)
+ *
+ * @return dmxOutput - data of the dmx channel (0 - 255)
+ */
+uint8_t readAddress(uint16_t address){
+    return hasDefaultInstance() ? dmxReadAddress(defaultInstance, address) : 0;
+}
+
+/**
+ * @brief Retuns a range of the original dmx data.
+ *
+ * @note please make sure that the startAddress and footprint don't exceed the maximum of channels! (512)
+ * @note  init() reads the dmxSignal concurrently!
+ * @param startAddress The first address to read from (1 - 512)
+ * @param footprint number of channels needed to read from (1 - 512)
+ *
+ * @return dmxOutput - data of the dmx channels. IMPORTANT! free memory after use! (see readFixtureInto())
+ */
+uint8_t* readFixture(uint16_t startAddress, uint16_t footprint){
+    return hasDefaultInstance() ? dmxReadFixture(defaultInstance, startAddress, footprint) : NULL;
+}
+
+/**
+ * @brief Copies a range of the original dmx data into caller owned memory.
+ *
+ * @note  Allocation-free readFixture(), all channels are copied from the same frame.
+ * @param startAddress The first address to read from (1 - 512)
+ * @param footprint number of channels needed to read from (1 - 512)
+ * @param destination At least footprint bytes, destination[0] receives startAddress.
+ *
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the range is out of scope, ESP_ERR_INVALID_STATE if not initialized
+ */
+esp_err_t readFixtureInto(uint16_t startAddress, uint16_t footprint, uint8_t *destination){
+    return hasDefaultInstance() ? dmxReadFixtureInto(defaultInstance, startAddress, footprint, destination) : ESP_ERR_INVALID_STATE;
+}
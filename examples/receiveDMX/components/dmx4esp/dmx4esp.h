@@ -3,13 +3,51 @@
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
 #include "driver/uart.h"
 #include "string.h"
 #include "driver/gpio.h"
 #include "esp_mac.h"
+#include "esp_idf_version.h"
+#include "soc/soc_caps.h"
+#include "dmxParallel.h"
+#include "dmxRxBuffer.h"
+#include "dmxSignal.h"
+#include "dmxStartCode.h"
+#include "dmxTrace.h"
+#include "dmxSelfTest.h"
+
+#define DMX_MAX_REFRESH_RATE 44 // maximum refresh rate for 512 channels (ANSI E1.11)
+#define DMX_MAX_SHORT_FRAME_RATE 830 // upper limit for short frames (minimum break to break time of 1204µs)
+#define DMX_DEFAULT_REFRESH_RATE 30
+
+// break / mark after break limits for transmitters (ANSI E1.11)
+#define DMX_MIN_BREAK_US 92
+#define DMX_MIN_MARK_US 12
+#define DMX_MAX_BREAK_MARK_US 1000000
+
+// zero-copy DMA transmit needs the UHCI driver (ESP-IDF >= 5.5)
+#if defined(SOC_UHCI_SUPPORTED) && SOC_UHCI_SUPPORTED && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 5, 0)
+#define DMX_DMA_SUPPORTED 1
+#else
+#define DMX_DMA_SUPPORTED 0
+#endif
+
+// bit-parallel output of several universes needs an i80 capable LCD (esp32-s3) or I2S (esp32) peripheral
+#if defined(SOC_LCD_I80_SUPPORTED) && SOC_LCD_I80_SUPPORTED
+#define DMX_PARALLEL_SUPPORTED 1
+#else
+#define DMX_PARALLEL_SUPPORTED 0
+#endif
 
 typedef enum {SEND, RECEIVE_DATA, BREAK, INACTIVE, DONE} DMXStatus;
 
+typedef enum {DMX_TX_DRIVER, DMX_TX_DMA} dmxTransmitMode;
+
+// DMX_SEND_PERIODIC: frames on every refresh rate deadline
+// DMX_SEND_ON_CHANGE: a frame starts as soon as a change is written, the refresh rate is only the keepalive
+typedef enum {DMX_SEND_PERIODIC, DMX_SEND_ON_CHANGE} dmxSendMode;
+
 extern DMXStatus dmxStatus;
 
 typedef struct dmxPinout {
@@ -18,14 +56,247 @@ typedef struct dmxPinout {
     gpio_num_t dir;
 } dmxPinout;
 
+typedef struct dmxRefreshStats {
+    float targetRate; // configured frames per second (limited by the frame length)
+    float achievedRate; // measured frames per second (running average)
+    uint32_t avgJitterUs; // average deviation of the frame interval from the target (µs)
+    uint32_t maxJitterUs; // maximum deviation of the frame interval from the target (µs)
+    uint32_t framesSent;
+    uint32_t overruns; // deadlines that came before the previous frame left the wire (it was longer than the period), sent right after it
+    uint32_t avgFrameCycles; // CPU cycles the send task spends handing a frame to the UART (running average), interrupts not included (see dmxMeasureCpuLoad())
+} dmxRefreshStats;
+
+// CPU time an output costs per frame, all interrupts included (see dmxMeasureCpuLoad()), comparable between transmit modes
+typedef struct dmxCpuLoad {
+    uint32_t frames; // frames sent during the measurement
+    uint32_t cyclesPerFrame; // CPU cycles (all cores) the probes didn't get, per frame sent
+    float busyPercent; // share of CPU time (all cores) the probes didn't get
+} dmxCpuLoad;
+
+#define DMX_ALTERNATE_QUEUE_LENGTH 4 // alternate start code packets waiting to be sent, per instance
+#define DMX_DEFAULT_ALTERNATE_INTERLEAVE 4 // null frames between two alternate frames
+
+typedef struct dmxAlternateStats {
+    uint32_t nullFrames; // 0x00
+    uint32_t textFrames; // 0x17
+    uint32_t testFrames; // 0x55
+    uint32_t sipFrames; // 0xCF
+    uint32_t otherFrames; // any other start code
+    uint32_t deferred; // deadlines an alternate frame was held back to keep the null frame rate floor
+    uint32_t queueFull; // packets rejected because DMX_ALTERNATE_QUEUE_LENGTH were waiting
+} dmxAlternateStats;
+
+#define DMX_LATENCY_BUCKETS 8
+
+typedef struct dmxLatencyStats {
+    uint32_t samples; // frames carrying a new change
+    uint32_t minUs; // commit to first slot on the wire
+    uint32_t avgUs;
+    uint32_t maxUs;
+    uint32_t histogram[DMX_LATENCY_BUCKETS]; // [0] < 500µs, [n] < 500µs * 2^n, [7] >= 32ms
+} dmxLatencyStats;
+
+// health of the link since the instance was created, sending instances fill the send side, receiving ones the receive side
+typedef struct dmxStats {
+    uint32_t framesSent; // null and alternate start code frames
+    uint32_t framesReceived; // null start code frames published
+    float refreshRate; // achieved frames per second, sent or received (running average)
+    uint32_t minIntervalUs; // break to break (send) / frame to frame (receive)
+    uint32_t avgIntervalUs; // running average (1/16)
+    uint32_t maxIntervalUs;
+    uint32_t avgJitterUs; // average deviation of the interval from its average
+    uint32_t maxJitterUs;
+    uint32_t frameErrors; // UART framing errors (missing stop bit), the frame in progress is dropped
+    uint32_t parityErrors;
+    uint32_t fifoOverflows; // RX FIFO overflowed before the interrupt drained it
+    uint32_t bufferFull; // received frames dropped because readers held every other buffer
+    uint32_t shortFrames; // received frames with less than 512 slots
+    uint32_t longFrames; // received frames with more than 512 slots (the extra slots are dropped)
+    uint32_t txDoneTimeouts; // frames still on the wire 2 slot times after their estimated end (counted once per frame)
+} dmxStats;
+
+// one DMX universe running on its own UART port
+typedef struct dmxInstance *dmx_handle_t;
+
+// called from the esp_timer task when the input signal is lost or restored
+typedef void (*dmxSignalCallback)(dmx_handle_t handle, dmxSignalState state, void *context);
+
+typedef struct dmxSignalLossConfig {
+    dmxLossPolicy policy; // DMX_LOSS_HOLD (default), DMX_LOSS_FADE, DMX_LOSS_BLACKOUT
+    uint16_t timeoutMs; // no valid frame for this long -> lost, 0 -> DMX_DEFAULT_LOSS_TIMEOUT_MS
+    uint16_t holdMs; // DMX_LOSS_FADE: last frame held before the fade
+    uint16_t fadeMs; // DMX_LOSS_FADE: fade to zero
+    dmxSignalCallback callback; // optional
+    void *context; // passed to callback
+} dmxSignalLossConfig;
+
+typedef struct dmxSignalStatus {
+    dmxSignalState state;
+    uint32_t msSinceFrame; // time since the last valid frame, 0 before the first one
+    uint8_t level; // output level of the held frame, 255 live / held - 0 blackout
+    uint32_t losses; // number of times the signal was lost
+} dmxSignalStatus;
+
+typedef struct dmxConfig {
+    uart_port_t port; // UART_NUM_1, UART_NUM_2 (, UART_NUM_0 if the console isn't needed)
+    dmxPinout pinout;
+    bool send; // if true, send dmx forever. Otherwise read dmx.
+    dmxTransmitMode transmitMode;
+    dmxSendMode sendMode;
+    uint16_t refreshRate; // Hz (keepalive rate in DMX_SEND_ON_CHANGE), 0 -> DMX_DEFAULT_REFRESH_RATE
+    uint16_t slotCount; // slots per frame (24 - 512), 0 -> 512
+    uint32_t breakUs; // 0 -> default (250µs)
+    uint32_t markUs; // 0 -> default (20µs)
+    uint8_t alternateInterleave; // null frames at least sent between two alternate start code frames, 0 -> DMX_DEFAULT_ALTERNATE_INTERLEAVE
+    uint16_t minNullRate; // Hz, alternate frames never push the null frame rate below this, 0 -> no floor
+    dmxSignalLossConfig signalLoss; // receive only
+} dmxConfig;
+
+// instance API, every universe runs independently
+esp_err_t dmxCreate(const dmxConfig *config, dmx_handle_t *handle);
+esp_err_t dmxDelete(dmx_handle_t handle);
+dmx_handle_t dmxGetDefault();
+DMXStatus dmxGetStatus(dmx_handle_t handle);
+void dmxGetStats(dmx_handle_t handle, dmxStats *stats);
+size_t dmxTraceDump(dmx_handle_t handle, dmxTraceEntry *entries, size_t max);
+esp_err_t dmxTracePrint(dmx_handle_t handle);
+
+void dmxWrite(dmx_handle_t handle, const uint8_t data[]);
+void dmxWriteAddress(dmx_handle_t handle, uint16_t address, uint8_t value);
+void dmxBeginWrite(dmx_handle_t handle);
+void dmxCommitWrite(dmx_handle_t handle);
+esp_err_t dmxConfigureRefreshRate(dmx_handle_t handle, uint16_t rate);
+esp_err_t dmxConfigureSlotCount(dmx_handle_t handle, uint16_t slotCount);
+esp_err_t dmxConfigureSendMode(dmx_handle_t handle, dmxSendMode mode);
+esp_err_t dmxConfigureBreakTiming(dmx_handle_t handle, uint32_t breakUs, uint32_t markUs);
+void dmxGetTransmitStats(dmx_handle_t handle, dmxRefreshStats *stats);
+esp_err_t dmxMeasureCpuLoad(dmx_handle_t handle, uint32_t durationMs, dmxCpuLoad *load);
+void dmxGetLatencyStats(dmx_handle_t handle, dmxLatencyStats *stats);
+esp_err_t dmxQueueAlternate(dmx_handle_t handle, const uint8_t *packet, uint16_t length);
+esp_err_t dmxConfigureAlternateSchedule(dmx_handle_t handle, uint8_t interleave, uint16_t minNullRate);
+void dmxGetAlternateStats(dmx_handle_t handle, dmxAlternateStats *stats);
+
+const dmxRxFrame* dmxAcquireFrame(dmx_handle_t handle);
+void dmxReleaseFrame(dmx_handle_t handle, const dmxRxFrame *frame);
+uint8_t* dmxRead(dmx_handle_t handle);
+uint8_t dmxReadAddress(dmx_handle_t handle, uint16_t address);
+uint8_t* dmxReadFixture(dmx_handle_t handle, uint16_t startAddress, uint16_t footprint);
+esp_err_t dmxConfigureSignalLoss(dmx_handle_t handle, const dmxSignalLossConfig *config);
+void dmxGetSignalStatus(dmx_handle_t handle, dmxSignalStatus *status);
+esp_err_t dmxReadFixtureInto(dmx_handle_t handle, uint16_t startAddress, uint16_t footprint, uint8_t *destination);
+
+// fixture view: the footprint of one fixture copied into caller owned storage, no heap, no lock
+typedef struct dmxFixtureView {
+    uint16_t startAddress; // 1 - 512
+    uint16_t footprint; // 1 - 512
+    uint8_t *data; // footprint bytes owned by the caller, data[0] is startAddress
+    uint32_t sequence; // frame the data was taken from, 0 before the first update
+} dmxFixtureView;
+
+esp_err_t dmxFixtureViewInit(dmxFixtureView *view, uint16_t startAddress, uint16_t footprint, uint8_t *storage);
+bool dmxFixtureViewUpdate(dmx_handle_t handle, dmxFixtureView *view);
+
+// frame-received notifications, sent once per published frame (no polling): by the UART interrupt for received frames,
+// by the esp_timer task for the fade / blackout frames of the loss of signal handling (see dmxConfigureSignalLoss())
+#define DMX_MAX_SUBSCRIBERS 4 // per instance
+
+// DMX_NOTIFY_BY_TASK: the task's notification value is overwritten with the frame sequence (one wakeup, never a backlog)
+// DMX_NOTIFY_BY_QUEUE: a dmxFrameEvent is sent to the queue, lost if the queue is full
+// DMX_NOTIFY_BY_CALLBACK: the callback runs in either context (UART interrupt or esp_timer task), keep it short and never block.
+//                         No library lock is held during the call, the frame stays unchanged until it returns
+typedef enum {DMX_NOTIFY_BY_TASK, DMX_NOTIFY_BY_QUEUE, DMX_NOTIFY_BY_CALLBACK} dmxNotifyType;
+
+typedef struct dmxFrameEvent {
+    uint32_t sequence; // dmxRxFrame sequence of the published frame
+    int64_t timestamp; // µs, time the frame was complete
+    uint16_t length; // bytes received, start code included
+} dmxFrameEvent;
+
+typedef void (*dmxFrameCallback)(dmx_handle_t handle, const dmxRxFrame *frame, void *context);
+
+typedef struct dmxSubscribeConfig {
+    dmxNotifyType type;
+    TaskHandle_t task; // DMX_NOTIFY_BY_TASK
+    QueueHandle_t queue; // DMX_NOTIFY_BY_QUEUE, items of sizeof(dmxFrameEvent)
+    dmxFrameCallback callback; // DMX_NOTIFY_BY_CALLBACK
+    void *context; // passed to callback
+    uint16_t firstAddress; // only notify if a slot in firstAddress - lastAddress changed, 0 -> every frame
+    uint16_t lastAddress;
+} dmxSubscribeConfig;
+
+typedef struct dmxSubscriber *dmx_subscription_t;
+
+esp_err_t dmxSubscribe(dmx_handle_t handle, const dmxSubscribeConfig *config, dmx_subscription_t *subscription);
+esp_err_t dmxUnsubscribe(dmx_handle_t handle, dmx_subscription_t subscription);
+
+// alternate start code frames (text, SIP, test, manufacturer specific ...) go to their own handlers, never into the dimmer frames
+#define DMX_MAX_START_CODE_HANDLERS 4 // per instance
+
+// runs in the UART interrupt (no library lock held), packet is only valid during the call. SIPs only arrive with a valid checksum
+typedef void (*dmxStartCodeHandler)(dmx_handle_t handle, const uint8_t *packet, uint16_t length, void *context);
+
+typedef struct dmxStartCodeStats {
+    uint32_t nullFrames; // 0x00, published as dimmer data
+    uint32_t textPackets; // 0x17
+    uint32_t testPackets; // 0x55, intact ones
+    uint32_t testErrors; // 0x55 with a wrong slot value or length
+    uint32_t sipPackets; // 0xCF, valid checksum
+    uint32_t sipErrors; // 0xCF, checksum or length invalid (not handed to the handler)
+    uint32_t otherPackets; // any other start code
+    uint32_t unhandled; // alternate frames without a handler
+    uint8_t lastStartCode; // start code of the last frame
+    uint16_t lastLength; // bytes of the last frame, start code included
+} dmxStartCodeStats;
+
+esp_err_t dmxSetStartCodeHandler(dmx_handle_t handle, uint8_t startCode, dmxStartCodeHandler handler, void *context);
+void dmxGetStartCodeStats(dmx_handle_t handle, dmxStartCodeStats *stats);
+
+// loopback self test: one instance sends test patterns, another one receives them, see dmxSelfTest()
+esp_err_t dmxSelfTest(dmx_handle_t sender, dmx_handle_t receiver, const dmxSelfTestConfig *config, dmxSelfTestResult *result);
+
+// bit-parallel output, up to 16 universes from one DMA stream (one GPIO per universe)
+typedef struct dmxParallelInstance *dmx_parallel_handle_t;
+
+typedef struct dmxParallelConfig {
+    uint8_t universes; // 1 - 16
+    gpio_num_t pins[DMX_PARALLEL_MAX_UNIVERSES]; // pins[n] sends universe n, unused lanes: GPIO_NUM_NC
+    gpio_num_t clockPin; // bus clock, required by the peripheral but not needed by DMX
+    gpio_num_t dir; // common direction pin, GPIO_NUM_NC if the transceivers are wired to send
+    uint16_t refreshRate; // Hz, 0 -> DMX_DEFAULT_REFRESH_RATE
+    uint16_t slotCount; // slots per frame of all universes (24 - 512), 0 -> 512
+} dmxParallelConfig;
+
+#if DMX_PARALLEL_SUPPORTED
+esp_err_t dmxParallelCreate(const dmxParallelConfig *config, dmx_parallel_handle_t *handle);
+esp_err_t dmxParallelDelete(dmx_parallel_handle_t handle);
+void dmxParallelWrite(dmx_parallel_handle_t handle, uint8_t universe, const uint8_t data[]);
+void dmxParallelWriteAddress(dmx_parallel_handle_t handle, uint8_t universe, uint16_t address, uint8_t value);
+void dmxParallelGetStats(dmx_parallel_handle_t handle, dmxRefreshStats *stats);
+#endif
+
+// legacy API, runs on the default instance (UART_NUM_2)
 void setupDMX(dmxPinout pinout);
 esp_err_t initDMX(bool sendDMX);
 
 void sendDMX(uint8_t DMXStream[]);
 void sendAddress(uint16_t address, uint8_t value);
+void dmxBegin();
+void dmxCommit();
+esp_err_t dmxSetRefreshRate(uint16_t rate);
+esp_err_t dmxSetSlotCount(uint16_t slotCount);
+esp_err_t dmxSetSendMode(dmxSendMode mode);
+esp_err_t dmxSetBreakTiming(uint32_t breakUs, uint32_t markUs);
+esp_err_t dmxSetTransmitMode(dmxTransmitMode mode);
+esp_err_t dmxSetAlternateSchedule(uint8_t interleave, uint16_t minNullRate);
+esp_err_t sendAlternate(const uint8_t *packet, uint16_t length);
+esp_err_t dmxSetSignalLoss(const dmxSignalLossConfig *config);
+void dmxGetRefreshStats(dmxRefreshStats *stats);
 
 uint8_t* readDMX();
+const dmxRxFrame* readDMXFrame();
+void releaseDMXFrame(const dmxRxFrame *frame);
 uint8_t readAddress(uint16_t address);
 uint8_t* readFixture(uint16_t startAddress, uint16_t footprint);
+esp_err_t readFixtureInto(uint16_t startAddress, uint16_t footprint, uint8_t *destination);
 
 #endif
\ No newline at end of file
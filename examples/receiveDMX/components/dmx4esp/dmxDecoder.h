@@ -0,0 +1,67 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_DECODER_H
+#define DMX_DECODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+//by feeding it synthetic byte / break streams
+
+typedef enum {
+    DMX_DECODER_WAIT_BREAK, // no valid frame in progress
+    DMX_DECODER_START_CODE, // break seen, next byte is the start code
+    DMX_DECODER_SLOTS, // receiving slots of a null start code frame
+    DMX_DECODER_ALTERNATE, // receiving slots of an alternate start code frame
+    DMX_DECODER_FULL, // 512 slots received, another byte before the next break makes it a long frame
+    DMX_DECODER_IGNORE // frame complete or unhandled alternate start code, skip bytes until the next break
+} dmxDecoderState;
+
+/**
+ * @brief Called for every complete frame, returns the buffer the next frame is decoded into.
+ *
+ * @note Called from the UART interrupt on the esp32, keep it short.
+ * @param context Context given to dmxDecoderInit().
+ * @param packet The complete frame: [0] start code, [1 - length-1] slots.
+ * @param length Number of bytes in packet, start code included (2 - 513)
+ * @return buffer of at least 513 bytes for the next frame (may be the same one)
+ */
+typedef uint8_t* (*dmxDecoderPublish)(void *context, uint8_t *packet, uint16_t length);
+
+typedef struct dmxDecoderStats {
+    uint32_t frames; // published frames
+    uint32_t breaks;
+    uint32_t alternateFrames; // frames with a start code other than 0x00 (not published as dimmer data)
+    uint32_t errors; // framing / parity / overflow errors, the frame in progress is dropped
+    uint32_t shortFrames; // null start code frames with less than 512 slots
+    uint32_t longFrames; // null start code frames with more than 512 slots (the extra slots are dropped)
+} dmxDecoderStats;
+
+/**
+ * @brief Receive state machine, fed with the bytes and breaks seen by the UART.
+ */
+typedef struct dmxDecoder {
+    dmxDecoderState state;
+    uint8_t *packet; // null start code frame in progress: [0] start code, [1 - 512] slots
+    uint16_t length; // bytes in packet (or alternatePacket)
+    dmxDecoderPublish publish;
+    uint8_t *alternatePacket; // alternate start code frame in progress, NULL -> alternate frames are skipped
+    dmxDecoderPublish publishAlternate;
+    void *context;
+    dmxDecoderStats stats;
+} dmxDecoder;
+
+void dmxDecoderInit(dmxDecoder *decoder, uint8_t *packet, dmxDecoderPublish publish, void *context);
+
+void dmxDecoderBreak(dmxDecoder *decoder);
+void dmxDecoderBytes(dmxDecoder *decoder, const uint8_t *data, size_t length);
+void dmxDecoderError(dmxDecoder *decoder);
+void dmxDecoderRestart(dmxDecoder *decoder, uint8_t *packet);
+void dmxDecoderSetAlternate(dmxDecoder *decoder, uint8_t *packet, dmxDecoderPublish publish);
+
+#endif
@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxEdgeDecoder.h"
+#include <string.h>
+
+#define DMX_PACKET_SIZE 513 // start code + 512 slots
+#define DMX_SLOT_BITS 11 // start bit, 8 data bits, 2 stop bits
+
+/**
+ * @brief Resets an edge decoder, it waits for the first break afterwards.
+ *
+ * @param decoder Pointer to the decoder to initialize.
+ * @param ticksPerUs Resolution of the timestamps / durations fed in (e.g. 10 for a 10MHz capture clock), at least 1.
+ * @param packet Buffer of at least 513 bytes for the first frame.
+ * @param publish Called for every complete frame.
+ * @param context Passed to publish.
+ * @return void
+ */
+void dmxEdgeDecoderInit(dmxEdgeDecoder *decoder, uint32_t ticksPerUs, uint8_t *packet, dmxEdgePublish publish, void *context){
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->state = DMX_EDGE_WAIT_BREAK;
+    decoder->ticksPerUs = ticksPerUs;
+    decoder->bitTicks = DMX_EDGE_BIT_NS / 1000 * ticksPerUs;
+    decoder->breakTicks = DMX_EDGE_MIN_BREAK_US * ticksPerUs;
+    decoder->level = 1;
+    decoder->packet = packet;
+    decoder->publish = publish;
+    decoder->context = context;
+}
+
+/**
+ * @brief Internal function to convert ticks into ns.
+ *
+ * @note This function is only expected to be used internally.
+ */
+static inline uint32_t toNs(const dmxEdgeDecoder *decoder, uint32_t ticks){
+    return (uint64_t) ticks * 1000 / decoder->ticksPerUs;
+}
+
+/**
+ * @brief Internal function to drop the frame in progress, the decoder waits for the next break.
+ *
+ * @note This function is only expected to be used internally.
+ */
+static void dropFrame(dmxEdgeDecoder *decoder){
+    decoder->stats.errors++;
+    decoder->state = DMX_EDGE_WAIT_BREAK;
+    decoder->length = 0;
+}
+
+/**
+ * @brief Internal function to hand the frame in progress and its timing to the publisher.
+ *
+ * @note This function is only expected to be used internally.
+ * @param decoder The decoder.
+ * @param breakStart Start of the break ending the frame (ticks).
+ *
+ * @return void
+ */
+static void publishFrame(dmxEdgeDecoder *decoder, uint32_t breakStart){
+    dmxFrameTiming *timing = &decoder->timing;
+    uint32_t slotEnd = decoder->lastSlotStart + DMX_SLOT_BITS * decoder->bitTicks;
+
+    timing->slotNs = toNs(decoder, (decoder->lastSlotStart - decoder->firstSlotStart) / (decoder->length - 1));
+    timing->mbbNs = (int32_t) (breakStart - slotEnd) > 0 ? toNs(decoder, breakStart - slotEnd) : 0;
+    timing->periodNs = toNs(decoder, breakStart - decoder->breakStart);
+
+    decoder->stats.frames++;
+    decoder->packet = decoder->publish(decoder->context, decoder->packet, decoder->length, timing);
+}
+
+/**
+ * @brief Internal function to handle a low period long enough to be a break.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Completes the previous frame (short or full), a slot cut off by the break is dropped.
+ * @param decoder The decoder.
+ * @param start Start of the break (ticks).
+ * @param duration Length of the break (ticks).
+ *
+ * @return void
+ */
+static void handleBreak(dmxEdgeDecoder *decoder, uint32_t start, uint32_t duration){
+    if(decoder->state == DMX_EDGE_SLOTS && decoder->length > 1){
+        publishFrame(decoder, start);
+    }
+
+    uint32_t breakNs = toNs(decoder, duration);
+    if(decoder->stats.breaks == 0 || breakNs < decoder->stats.minBreakNs){
+        decoder->stats.minBreakNs = breakNs;
+    }
+    if(breakNs > decoder->stats.maxBreakNs){
+        decoder->stats.maxBreakNs = breakNs;
+    }
+    decoder->stats.breaks++;
+
+    memset(&decoder->timing, 0, sizeof(decoder->timing));
+    decoder->timing.breakNs = breakNs;
+    decoder->breakStart = start;
+    decoder->state = DMX_EDGE_MAB;
+    decoder->length = 0;
+}
+
+/**
+ * @brief Internal function to sample a period of constant line level bit by bit.
+ *
+ * @note This function is only expected to be used internally.
+ * @param decoder The decoder.
+ * @param level Line level of the period.
+ * @param start Start of the period (ticks).
+ * @param duration Length of the period (ticks).
+ *
+ * @return void
+ */
+static void processRun(dmxEdgeDecoder *decoder, uint8_t level, uint32_t start, uint32_t duration){
+    if(!level && duration >= decoder->breakTicks){
+        handleBreak(decoder, start, duration);
+        return;
+    }
+
+    switch(decoder->state){
+        case DMX_EDGE_MAB: {
+            if(!level){
+                dropFrame(decoder); //no mark after break
+                return;
+            }
+            uint32_t mabNs = toNs(decoder, duration);
+            if(decoder->stats.minMabNs == 0 || mabNs < decoder->stats.minMabNs){
+                decoder->stats.minMabNs = mabNs;
+            }
+            if(mabNs > decoder->stats.maxMabNs){
+                decoder->stats.maxMabNs = mabNs;
+            }
+            decoder->timing.mabNs = mabNs;
+            decoder->state = DMX_EDGE_SLOTS;
+            decoder->bit = -1;
+            return;
+        }
+        case DMX_EDGE_SLOTS:
+            break;
+        case DMX_EDGE_WAIT_BREAK:
+        default:
+            return;
+    }
+
+    uint32_t bits = (duration + decoder->bitTicks / 2) / decoder->bitTicks; //tolerates the baud rate deviation of a slot
+    if(bits == 0){
+        dropFrame(decoder); //glitch
+        return;
+    }
+
+    uint32_t time = start;
+    while(bits > 0){
+        if(decoder->bit < 0){
+            if(level){
+                return; //mark between slots
+            }
+            //start bit
+            if(decoder->length == 0){
+                decoder->firstSlotStart = time;
+            } else{
+                uint32_t slotTicks = time - decoder->lastSlotStart;
+                if(toNs(decoder, slotTicks) > decoder->timing.maxSlotNs){
+                    decoder->timing.maxSlotNs = toNs(decoder, slotTicks);
+                }
+            }
+            decoder->lastSlotStart = time;
+            decoder->bit = 0;
+            decoder->byte = 0;
+        } else if(decoder->bit < 8){
+            decoder->byte |= level << decoder->bit;
+            decoder->bit++;
+        } else{
+            if(!level){
+                dropFrame(decoder); //missing stop bit (framing error)
+                return;
+            }
+            if(decoder->length < DMX_PACKET_SIZE){
+                decoder->packet[decoder->length++] = decoder->byte; //slots after the 512th are ignored
+            }
+            decoder->bit = -1;
+        }
+        bits--;
+        time += decoder->bitTicks;
+    }
+}
+
+/**
+ * @brief Feeds a line edge into the decoder.
+ *
+ * @note The period before the edge is decoded, so a frame is complete once the falling edge of the next break
+ *       is followed by the rising one (a break is only recognized by its length).
+ * @param decoder The decoder.
+ * @param timestamp Time of the edge (ticks, may wrap around).
+ * @param level Line level after the edge (1: mark / idle, 0: space).
+ * @return void
+ */
+void dmxEdgeDecoderEdge(dmxEdgeDecoder *decoder, uint32_t timestamp, uint8_t level){
+    if(decoder->started){
+        processRun(decoder, decoder->level, decoder->lastEdge, timestamp - decoder->lastEdge);
+    }
+    decoder->started = true;
+    decoder->lastEdge = timestamp;
+    decoder->level = level ? 1 : 0;
+}
+
+/**
+ * @brief Feeds a period of constant line level into the decoder, e.g. one half of an RMT symbol.
+ *
+ * @param decoder The decoder.
+ * @param level Line level (1: mark / idle, 0: space).
+ * @param duration Length of the period (ticks).
+ * @return void
+ */
+void dmxEdgeDecoderRun(dmxEdgeDecoder *decoder, uint8_t level, uint32_t duration){
+    processRun(decoder, level ? 1 : 0, decoder->lastEdge, duration);
+    decoder->started = false;
+    decoder->lastEdge += duration;
+}
@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_EDGE_DECODER_H
+#define DMX_EDGE_DECODER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+//by feeding it synthetic edge streams. On the esp32 the edges come from a capture peripheral (e.g. RMT)
+
+#define DMX_EDGE_MIN_BREAK_US 88 // shortest low period accepted as a break (ANSI E1.11 receiver)
+#define DMX_EDGE_BIT_NS 4000 // 250 kbaud
+
+typedef enum {
+    DMX_EDGE_WAIT_BREAK, // no valid frame in progress
+    DMX_EDGE_MAB, // break seen, waiting for the end of the mark after break
+    DMX_EDGE_SLOTS // receiving start code and slots
+} dmxEdgeDecoderState;
+
+/**
+ * @brief Measured timing of one frame, everything in ns.
+ */
+typedef struct dmxFrameTiming {
+    uint32_t breakNs;
+    uint32_t mabNs; // mark after break
+    uint32_t slotNs; // average start bit to start bit, 44000 if the slots follow each other without a gap
+    uint32_t maxSlotNs; // longest start bit to start bit (largest inter-slot time)
+    uint32_t mbbNs; // mark before break: end of the last slot (2 stop bits) to the next break
+    uint32_t periodNs; // break to break
+} dmxFrameTiming;
+
+/**
+ * @brief Called for every frame once the next break starts.
+ *
+ * @param context Context given to dmxEdgeDecoderInit().
+ * @param packet The frame: [0] start code, [1 - length-1] slots.
+ * @param length Number of bytes in packet, start code included (2 - 513)
+ * @param timing Measured break, mark after break, slot and mark before break times.
+ * @return buffer of at least 513 bytes for the next frame (may be the same one)
+ */
+typedef uint8_t* (*dmxEdgePublish)(void *context, uint8_t *packet, uint16_t length, const dmxFrameTiming *timing);
+
+typedef struct dmxEdgeDecoderStats {
+    uint32_t frames; // published frames
+    uint32_t breaks;
+    uint32_t errors; // missing stop bit, glitches or missing mark after break, the frame in progress is dropped
+    uint32_t minBreakNs;
+    uint32_t maxBreakNs;
+    uint32_t minMabNs;
+    uint32_t maxMabNs;
+} dmxEdgeDecoderStats;
+
+/**
+ * @brief Receive state machine working on line levels and their durations instead of UART bytes.
+ */
+typedef struct dmxEdgeDecoder {
+    dmxEdgeDecoderState state;
+    uint32_t ticksPerUs; // resolution of the timestamps
+    uint32_t bitTicks;
+    uint32_t breakTicks;
+    uint32_t lastEdge; // timestamp the current level started
+    uint8_t level; // current line level (1: mark / idle)
+    bool started; // lastEdge is valid
+
+    int8_t bit; // -1: waiting for a start bit, 0 - 7: data bit, 8: stop bit
+    uint8_t byte;
+    uint8_t *packet;
+    uint16_t length;
+    uint32_t breakStart;
+    uint32_t firstSlotStart;
+    uint32_t lastSlotStart;
+    dmxFrameTiming timing;
+
+    dmxEdgePublish publish;
+    void *context;
+    dmxEdgeDecoderStats stats;
+} dmxEdgeDecoder;
+
+void dmxEdgeDecoderInit(dmxEdgeDecoder *decoder, uint32_t ticksPerUs, uint8_t *packet, dmxEdgePublish publish, void *context);
+
+void dmxEdgeDecoderEdge(dmxEdgeDecoder *decoder, uint32_t timestamp, uint8_t level);
+void dmxEdgeDecoderRun(dmxEdgeDecoder *decoder, uint8_t level, uint32_t duration);
+
+#endif
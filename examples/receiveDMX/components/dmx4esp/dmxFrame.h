@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_FRAME_H
+#define DMX_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be benchmarked on a host
+
+#define DMX_MAX_SLOTS 512
+#define DMX_MIN_SLOTS 24 // shortest frame sent by a transmitter
+
+// wire timing at 250 kbaud
+#define DMX_SLOT_US 44 // start bit, 8 data bits, 2 stop bits
+#define DMX_MIN_BREAK_TO_BREAK_US 1204 // minimum packet period (ANSI E1.11)
+
+/**
+ * @brief Shared transmit frame written by producers and snapshotted by the send task.
+ *
+ * @note Single slot writes are lock-free: one byte store plus one atomic increment of changeSeq.
+ *       Multi slot writes are wrapped in a seqlock (bulkSeq is odd while a write is in progress),
+ *       the send task never waits for producers and producers never wait for the send task.
+ */
+typedef struct dmxTxFrame {
+    uint8_t slots[DMX_MAX_SLOTS];
+    atomic_uint changeSeq; //incremented after every write, the send task compares it to detect changes
+    atomic_uint bulkSeq; //seqlock sequence, odd while a multi slot write is in progress
+} dmxTxFrame;
+
+void dmxTxFrameInit(dmxTxFrame *frame);
+
+void dmxTxFrameSetSlot(dmxTxFrame *frame, uint16_t index, uint8_t value);
+
+void dmxTxFrameBeginBulk(dmxTxFrame *frame);
+void dmxTxFrameWriteBulk(dmxTxFrame *frame, uint16_t index, const uint8_t *data, uint16_t length);
+void dmxTxFrameEndBulk(dmxTxFrame *frame);
+bool dmxTxFrameInBulk(dmxTxFrame *frame);
+
+bool dmxTxFrameSnapshot(dmxTxFrame *frame, uint8_t *destination, uint32_t *lastChangeSeq);
+
+uint32_t dmxFramePeriodUs(uint16_t rate, uint16_t slotCount, uint32_t breakUs, uint32_t markUs);
+
+#endif
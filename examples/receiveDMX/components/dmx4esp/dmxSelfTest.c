@@ -0,0 +1,118 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxSelfTest.h"
+#include "dmxStartCode.h"
+#include <stdlib.h>
+
+/**
+ * @brief Internal function returning the value of one slot of a test pattern.
+ *
+ * @note This function is only expected to be used internally.
+ * @param number Pattern number.
+ * @param slot Slot number (3 - 512), slots 1 and 2 carry the pattern number.
+ * @return slot value
+ */
+static uint8_t patternValue(uint8_t number, uint16_t slot){
+    switch(number % DMX_PATTERN_COUNT){
+        case DMX_PATTERN_TEST_VALUE:
+            return DMX_TEST_SLOT_VALUE;
+        case DMX_PATTERN_RAMP:
+            return (uint8_t) slot;
+        case DMX_PATTERN_INVERTED_RAMP:
+            return (uint8_t) ~slot;
+        case DMX_PATTERN_ALTERNATING:
+            return slot & 1 ? 0x00 : 0xFF;
+        default:
+            return (uint8_t) ((slot * 2654435761u + number * 40503u) >> 24);
+    }
+}
+
+/**
+ * @brief Fills the slots of a frame with a test pattern.
+ *
+ * @param slots Destination, slots[0] is slot 1.
+ * @param count Number of slots (2 - 512).
+ * @param number Pattern number, selects the pattern (dmxPattern, number % DMX_PATTERN_COUNT).
+ * @return void
+ */
+void dmxSelfTestFill(uint8_t *slots, uint16_t count, uint8_t number){
+    slots[0] = number;
+    slots[1] = (uint8_t) ~number;
+    for(uint16_t slot = 3; slot <= count; slot++){
+        slots[slot - 1] = patternValue(number, slot);
+    }
+}
+
+/**
+ * @brief Reads the pattern number a frame carries.
+ *
+ * @param slots Received slots, slots[0] is slot 1.
+ * @param count Number of slots received.
+ * @param number Pointer to the pattern number.
+ * @return true if slots 1 and 2 hold a number and its inverse
+ */
+bool dmxSelfTestNumber(const uint8_t *slots, uint16_t count, uint8_t *number){
+    if(count < 2 || slots[1] != (uint8_t) ~slots[0]){
+        return false;
+    }
+    *number = slots[0];
+    return true;
+}
+
+/**
+ * @brief Compares received slots against a test pattern.
+ *
+ * @param slots Received slots, slots[0] is slot 1.
+ * @param received Number of slots received.
+ * @param count Number of slots the pattern was sent with, missing ones count as errors.
+ * @param number Pattern number.
+ * @return number of slots with a wrong or missing value
+ */
+uint16_t dmxSelfTestCompare(const uint8_t *slots, uint16_t received, uint16_t count, uint8_t number){
+    uint16_t compared = received < count ? received : count;
+    uint16_t errors = count - compared;
+
+    for(uint16_t slot = 1; slot <= compared; slot++){
+        uint8_t expected = slot == 1 ? number : slot == 2 ? (uint8_t) ~number : patternValue(number, slot);
+        errors += slots[slot - 1] != expected;
+    }
+    return errors;
+}
+
+/**
+ * @brief Internal qsort() comparison of two latencies.
+ *
+ * @note This function is only expected to be used internally.
+ */
+static int compareLatency(const void *a, const void *b){
+    uint32_t first = *(const uint32_t*) a;
+    uint32_t second = *(const uint32_t*) b;
+    return (first > second) - (first < second);
+}
+
+/**
+ * @brief Fills the latency fields of a result (minimum, median, 90th and 99th percentile, maximum).
+ *
+ * @note  Sorts samples in place. Percentiles are nearest rank, all fields are 0 without samples.
+ * @param samples Latencies (µs).
+ * @param count Number of samples.
+ * @param result The result to fill.
+ * @return void
+ */
+void dmxSelfTestLatencies(uint32_t *samples, uint32_t count, dmxSelfTestResult *result){
+    if(count == 0){
+        result->latencyMinUs = result->latencyP50Us = result->latencyP90Us = result->latencyP99Us = result->latencyMaxUs = 0;
+        return;
+    }
+
+    qsort(samples, count, sizeof(*samples), compareLatency);
+    result->latencyMinUs = samples[0];
+    result->latencyP50Us = samples[(count * 50 + 99) / 100 - 1];
+    result->latencyP90Us = samples[(count * 90 + 99) / 100 - 1];
+    result->latencyP99Us = samples[(count * 99 + 99) / 100 - 1];
+    result->latencyMaxUs = samples[count - 1];
+}
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_SELF_TEST_H
+#define DMX_SELF_TEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+
+#define DMX_SELF_TEST_DEFAULT_PATTERNS 100
+
+// slot values of a test pattern, picked by its number. slot 1 carries the number, slot 2 the inverted number
+// DMX_PATTERN_TEST_VALUE: every slot 0x55 (alternating bits, like the 0x55 network test packet)
+// DMX_PATTERN_RAMP / DMX_PATTERN_INVERTED_RAMP: slot number, low 8 bits
+// DMX_PATTERN_ALTERNATING: 0x00 / 0xFF, every bit flips from slot to slot
+// DMX_PATTERN_RANDOM: pseudo random, different for every pattern number
+typedef enum {DMX_PATTERN_TEST_VALUE, DMX_PATTERN_RAMP, DMX_PATTERN_INVERTED_RAMP, DMX_PATTERN_ALTERNATING, DMX_PATTERN_RANDOM,
+              DMX_PATTERN_COUNT} dmxPattern;
+
+/**
+ * @brief Options of dmxSelfTest(), zero initialize for the defaults.
+ */
+typedef struct dmxSelfTestConfig {
+    uint16_t patterns; // patterns sent one after the other, 0 -> DMX_SELF_TEST_DEFAULT_PATTERNS
+    uint16_t testPacketInterval; // a 0x55 network test packet every n patterns, 0 -> none
+    uint32_t timeoutMs; // per pattern, 0 -> 3 frame periods of the sender + 10ms
+} dmxSelfTestConfig;
+
+/**
+ * @brief Outcome of dmxSelfTest(). Latencies are commit (dmxWrite()) to frame complete at the receiver.
+ */
+typedef struct dmxSelfTestResult {
+    uint32_t patterns; // patterns sent
+    uint32_t patternsReceived; // arrived within the timeout
+    uint32_t framesSent; // null start code frames the sender sent during the test
+    uint32_t framesReceived; // of them published by the receiver
+    uint32_t framesDropped; // framesSent - framesReceived
+    uint32_t framesChecked; // frames compared slot by slot
+    uint32_t slotsChecked;
+    uint32_t slotErrors; // slots with a wrong value, or missing from a short frame
+    float slotErrorRate; // slotErrors / slotsChecked
+    uint32_t lineErrors; // framing and parity errors and FIFO overflows the receiver counted
+    uint32_t testPacketsSent; // 0x55
+    uint32_t testPacketsReceived; // intact ones
+    uint32_t testPacketErrors; // with a wrong slot value or length
+    uint32_t latencyMinUs;
+    uint32_t latencyP50Us;
+    uint32_t latencyP90Us;
+    uint32_t latencyP99Us;
+    uint32_t latencyMaxUs;
+} dmxSelfTestResult;
+
+void dmxSelfTestFill(uint8_t *slots, uint16_t count, uint8_t number);
+bool dmxSelfTestNumber(const uint8_t *slots, uint16_t count, uint8_t *number);
+uint16_t dmxSelfTestCompare(const uint8_t *slots, uint16_t received, uint16_t count, uint8_t number);
+void dmxSelfTestLatencies(uint32_t *samples, uint32_t count, dmxSelfTestResult *result);
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxSignal.h"
+#include <string.h>
+
+/**
+ * @brief Resets a monitor, the signal is DMX_SIGNAL_NONE until the first valid frame.
+ *
+ * @param monitor Pointer to the monitor to initialize.
+ * @param policy What happens once the signal is lost.
+ * @param timeoutMs Time without a valid frame until the signal counts as lost, 0 -> DMX_DEFAULT_LOSS_TIMEOUT_MS
+ * @param holdMs DMX_LOSS_FADE: time the last frame is held before the fade starts.
+ * @param fadeMs DMX_LOSS_FADE: duration of the fade to zero.
+ * @return void
+ */
+void dmxSignalInit(dmxSignalMonitor *monitor, dmxLossPolicy policy, uint32_t timeoutMs, uint32_t holdMs, uint32_t fadeMs){
+    memset(monitor, 0, sizeof(*monitor));
+    monitor->policy = policy;
+    monitor->timeoutUs = (int64_t) (timeoutMs != 0 ? timeoutMs : DMX_DEFAULT_LOSS_TIMEOUT_MS) * 1000;
+    monitor->holdUs = (int64_t) holdMs * 1000;
+    monitor->fadeUs = (int64_t) fadeMs * 1000;
+    monitor->state = DMX_SIGNAL_NONE;
+    monitor->level = 255;
+}
+
+/**
+ * @brief Reports a valid frame.
+ *
+ * @note Cheap enough for the receive interrupt, the state only changes in dmxSignalTick().
+ * @param monitor The monitor.
+ * @param now Time the frame was complete (µs)
+ * @return void
+ */
+void dmxSignalFrame(dmxSignalMonitor *monitor, int64_t now){
+    monitor->lastFrameUs = now;
+}
+
+/**
+ * @brief Internal function to calculate the output level of a lost signal.
+ *
+ * @note This function is only expected to be used internally.
+ * @param monitor The monitor, state DMX_SIGNAL_LOST.
+ * @param now Current time (µs)
+ *
+ * @return 255 (held) - 0 (blackout)
+ */
+static uint8_t lostLevel(const dmxSignalMonitor *monitor, int64_t now){
+    switch(monitor->policy){
+        case DMX_LOSS_BLACKOUT:
+            return 0;
+        case DMX_LOSS_FADE: {
+            int64_t fading = now - monitor->lostUs - monitor->holdUs;
+            if(fading <= 0){
+                return 255;
+            }
+            if(fading >= monitor->fadeUs){
+                return 0;
+            }
+            return 255 - (uint8_t) (fading * 255 / monitor->fadeUs);
+        }
+        case DMX_LOSS_HOLD:
+        default:
+            return 255;
+    }
+}
+
+/**
+ * @brief Advances the monitor, called periodically (once per output tick).
+ *
+ * @note The fade is computed incrementally: an output is only requested if the level changed since the last one.
+ * @param monitor The monitor.
+ * @param now Current time (µs)
+ * @return DMX_SIGNAL_EVENT_* bits
+ */
+uint32_t dmxSignalTick(dmxSignalMonitor *monitor, int64_t now){
+    uint32_t events = 0;
+
+    if(monitor->lastFrameUs == 0){
+        return 0; //nothing to hold yet
+    }
+
+    if(monitor->state == DMX_SIGNAL_LOST && monitor->lastFrameUs > monitor->lostUs){
+        monitor->state = DMX_SIGNAL_PRESENT; //the frame was already published, receivers see live data again
+        monitor->level = 255;
+        return DMX_SIGNAL_EVENT_RESTORED;
+    }
+    if(monitor->state != DMX_SIGNAL_LOST){
+        monitor->state = DMX_SIGNAL_PRESENT;
+        if(now - monitor->lastFrameUs < monitor->timeoutUs){
+            return 0;
+        }
+        monitor->state = DMX_SIGNAL_LOST;
+        monitor->lostUs = now;
+        monitor->losses++;
+        events |= DMX_SIGNAL_EVENT_LOST;
+    }
+
+    uint8_t level = lostLevel(monitor, now);
+    if(level != monitor->level){
+        monitor->level = level;
+        events |= DMX_SIGNAL_EVENT_OUTPUT;
+    }
+    return events;
+}
+
+/**
+ * @brief Scales the slots of a packet to a level, the start code is copied unchanged.
+ *
+ * @param packet The held packet: [0] start code, [n] channel n.
+ * @param output Receives the scaled packet (may not overlap packet).
+ * @param length Bytes in the packet, start code included (1 - 513)
+ * @param level 255 (unchanged) - 0 (all slots 0)
+ * @return void
+ */
+void dmxSignalScale(const uint8_t *packet, uint8_t *output, uint16_t length, uint8_t level){
+    output[0] = packet[0];
+    for(uint16_t slot = 1; slot < length; slot++){
+        uint32_t value = packet[slot] * level; //exact division by 255 below 65535
+        output[slot] = (value + 1 + (value >> 8)) >> 8;
+    }
+}
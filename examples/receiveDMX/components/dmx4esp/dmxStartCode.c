@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxStartCode.h"
+#include <string.h>
+
+#define DMX_SIP_MIN_BYTE_COUNT 23 // start code up to the 5th manufacturer ID
+
+/**
+ * @brief Parses a text packet (start code 0x17).
+ *
+ * @param packet The frame: [0] start code, [1] page, [2] characters per line, [3 - ] ASCII text.
+ * @param length Bytes in the frame, start code included.
+ * @param text Filled with the page and a pointer to the text inside packet.
+ * @return true if the frame is a text packet
+ */
+bool dmxParseText(const uint8_t *packet, uint16_t length, dmxTextPacket *text){
+    if(length < 3 || packet[0] != DMX_START_CODE_TEXT){
+        return false;
+    }
+
+    text->page = packet[1];
+    text->charactersPerLine = packet[2];
+    text->text = (const char*) &packet[3];
+
+    const uint8_t *end = memchr(&packet[3], 0x00, length - 3);
+    text->textLength = end != NULL ? end - &packet[3] : length - 3;
+    return true;
+}
+
+/**
+ * @brief Parses a System Information Packet (start code 0xCF) and validates its checksum.
+ *
+ * @note The checksum is the sum of all bytes before it (start code and byte count included) modulo 256,
+ *       it follows the last of byteCount bytes.
+ * @param packet The frame: [0] start code, [1] byte count, ..., [byte count] checksum.
+ * @param length Bytes in the frame, start code included.
+ * @param sip Filled with the fields of the packet, only valid if true is returned.
+ * @return true if the frame is a SIP with a valid checksum
+ */
+bool dmxParseSip(const uint8_t *packet, uint16_t length, dmxSipPacket *sip){
+    if(length < DMX_SIP_MIN_BYTE_COUNT + 1 || packet[0] != DMX_START_CODE_SIP){
+        return false;
+    }
+
+    uint8_t byteCount = packet[1];
+    if(byteCount < DMX_SIP_MIN_BYTE_COUNT || byteCount >= length){
+        return false;
+    }
+
+    uint8_t checksum = 0;
+    for(uint16_t i = 0; i < byteCount; i++){
+        checksum += packet[i];
+    }
+    if(checksum != packet[byteCount]){
+        return false;
+    }
+
+    sip->byteCount = byteCount;
+    sip->controlFlags = packet[2];
+    sip->previousChecksum = packet[3] << 8 | packet[4];
+    sip->sequence = packet[5];
+    sip->universe = packet[6];
+    sip->processingLevel = packet[7];
+    sip->softwareVersion = packet[8];
+    sip->packetLength = packet[9] << 8 | packet[10];
+    sip->packetsSinceSip = packet[11] << 8 | packet[12];
+    for(int i = 0; i < 5; i++){
+        sip->manufacturers[i] = packet[13 + i * 2] << 8 | packet[14 + i * 2];
+    }
+    return true;
+}
+
+/**
+ * @brief Checks a network test packet (start code 0x55): 512 slots, every one 0x55.
+ *
+ * @param packet The frame: [0] start code, [1 - 512] slots.
+ * @param length Bytes in the frame, start code included.
+ * @return true if the frame is a complete and intact test packet
+ */
+bool dmxIsTestPacket(const uint8_t *packet, uint16_t length){
+    if(length != 513 || packet[0] != DMX_START_CODE_TEST){
+        return false;
+    }
+    for(uint16_t slot = 1; slot < length; slot++){
+        if(packet[slot] != DMX_TEST_SLOT_VALUE){
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the 16 bit additive checksum of a packet, as carried by a SIP for the previous null start code packet.
+ *
+ * @param packet The frame, start code included.
+ * @param length Bytes in the frame.
+ * @return sum of all bytes modulo 65536
+ */
+uint16_t dmxPacketChecksum(const uint8_t *packet, uint16_t length){
+    uint16_t checksum = 0;
+    for(uint16_t i = 0; i < length; i++){
+        checksum += packet[i];
+    }
+    return checksum;
+}
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxTrace.h"
+#include <string.h>
+
+static const char *eventNames[DMX_TRACE_EVENT_COUNT] = {
+    "tx_sleep", "tx_wake", "tx_drained", "tx_overrun", "tx_snapshot", "tx_break", "tx_mab", "tx_write", "tx_written",
+    "rx_enter", "rx_break", "rx_bytes", "rx_error", "rx_publish", "rx_exit"
+};
+
+/**
+ * @brief Empties a trace ring.
+ *
+ * @param ring The ring.
+ * @return void
+ */
+void dmxTraceInit(dmxTraceRing *ring){
+    memset(ring->entries, 0, sizeof(ring->entries));
+    atomic_init(&ring->head, 0);
+}
+
+/**
+ * @brief Copies the newest events of a ring, oldest first.
+ *
+ * @note  Lock-free, the writer keeps recording meanwhile. Entries it may have overwritten during the copy are dropped,
+ *        so the result is always a gapless sequence of events. Once the ring wrapped around, the oldest slot may be
+ *        rewritten at any time, so at most DMX_TRACE_ENTRIES - 1 events are returned.
+ * @param ring The ring.
+ * @param entries Destination of at least max entries.
+ * @param max Maximum number of entries to copy.
+ * @return number of entries copied
+ */
+size_t dmxTraceRead(dmxTraceRing *ring, dmxTraceEntry *entries, size_t max){
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t count = head < DMX_TRACE_ENTRIES ? head : DMX_TRACE_ENTRIES;
+    if(count > max){
+        count = max;
+    }
+
+    unsigned first = head - count;
+    for(size_t i = 0; i < count; i++){
+        entries[i] = ring->entries[(first + i) & (DMX_TRACE_ENTRIES - 1)];
+    }
+
+    //events up to the one in progress (headAfter) overwrite the slots of headAfter - DMX_TRACE_ENTRIES and before
+    atomic_thread_fence(memory_order_acquire);
+    unsigned headAfter = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    unsigned valid = headAfter + 1 - DMX_TRACE_ENTRIES; //oldest index that can't have been touched
+    if(headAfter + 1 > DMX_TRACE_ENTRIES && (int) (valid - first) > 0){
+        size_t dropped = valid - first;
+        if(dropped >= count){
+            return 0;
+        }
+        memmove(entries, &entries[dropped], (count - dropped) * sizeof(*entries));
+        count -= dropped;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the name of an event as used in the CSV dump.
+ *
+ * @param event The event (dmxTraceEvent).
+ * @return name, "unknown" if out of range
+ */
+const char* dmxTraceEventName(uint8_t event){
+    return event < DMX_TRACE_EVENT_COUNT ? eventNames[event] : "unknown";
+}
@@ -13,7 +13,6 @@
 
 #define FIXTURE_FOOTPRINT 3
 #define FIXTURE_ADDRESS 1
-#define REFRESH_RATE 10
 
 #define LED_PIN_R 48
 #define LED_PIN_G 2
@@ -58,7 +57,7 @@ void setup(){
 }
 
 // rgb is displayed via pwm duty cycles with ledc
-void displayRGB(uint8_t dmxSignal[]){
+void displayRGB(const uint8_t dmxSignal[]){
     //Red
     ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, dmxSignal[0]);
     ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
@@ -75,29 +74,32 @@ void displayRGB(uint8_t dmxSignal[]){
 void app_main(void){    
     setup();
 
-   //array to store the dmx values
-    uint8_t receivedSignal[512];
+    //wake this task only when a channel of the fixture changed, no polling
+    dmxSubscribeConfig subscription = {
+        .type = DMX_NOTIFY_BY_TASK,
+        .task = xTaskGetCurrentTaskHandle(),
+        .firstAddress = FIXTURE_ADDRESS,
+        .lastAddress = FIXTURE_ADDRESS + FIXTURE_FOOTPRINT - 1
+    };
+    if(dmxSubscribe(dmxGetDefault(), &subscription, NULL) != ESP_OK){
+        printf("Failed to subscribe to dmx frames\n");
+        return;
+    }
+
+    //the fixture's channels are copied into receivedSignal, no heap
+    dmxFixtureView fixture;
+    dmxFixtureViewInit(&fixture, FIXTURE_ADDRESS, FIXTURE_FOOTPRINT, receivedSignal);
 
     //update state
     for(;;){
-        
-        //get the current dmx frame as an array
-        uint8_t* readBuffer = readDMX();
-            
-        //check if operation was successfull
-        if(readBuffer != NULL){
-            //copy the received data into a static array
-            memcpy(receivedSignal, readBuffer, 512);
-                    
-            //important: free the dynamic buffer
-            free(readBuffer);
-            
-            displayRGB(receivedSignal);
-
-            //wait a custom interval before reading
-            vTaskDelay(REFRESH_RATE);
+        uint32_t sequence;
+
+        //sleeps until a frame with new fixture data arrived, the notification value is its sequence number
+        xTaskNotifyWait(0, 0, &sequence, portMAX_DELAY);
+
+        //copy the fixture's channels out of the latest frame
+        if(dmxFixtureViewUpdate(dmxGetDefault(), &fixture)){
+            displayRGB(fixture.data);
         }
     }
 }
-
-
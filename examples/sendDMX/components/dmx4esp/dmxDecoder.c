@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxDecoder.h"
+#include <string.h>
+
+#define DMX_PACKET_SIZE 513 // start code + 512 slots
+
+/**
+ * @brief Resets a decoder, it waits for the first break afterwards.
+ *
+ * @param decoder Pointer to the decoder to initialize.
+ * @param packet Buffer of at least 513 bytes for the first frame.
+ * @param publish Called for every complete frame.
+ * @param context Passed to publish.
+ * @return void
+ */
+void dmxDecoderInit(dmxDecoder *decoder, uint8_t *packet, dmxDecoderPublish publish, void *context){
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->state = DMX_DECODER_WAIT_BREAK;
+    decoder->packet = packet;
+    decoder->publish = publish;
+    decoder->context = context;
+}
+
+/**
+ * @brief Hands frames with a start code other than 0x00 to their own publisher instead of skipping them.
+ *
+ * @note Alternate frames never touch the null start code packet, so dimmer data stays untouched.
+ * @param decoder The decoder.
+ * @param packet Buffer of at least 513 bytes for the first alternate frame, NULL to skip alternate frames again.
+ * @param publish Called for every complete alternate frame (2 - 513 bytes).
+ * @return void
+ */
+void dmxDecoderSetAlternate(dmxDecoder *decoder, uint8_t *packet, dmxDecoderPublish publish){
+    decoder->alternatePacket = packet;
+    decoder->publishAlternate = publish;
+}
+
+/**
+ * @brief Internal function to hand the frame in progress to the publisher.
+ *
+ * @note This function is only expected to be used internally.
+ * @param decoder The decoder.
+ *
+ * @return void
+ */
+static void publishFrame(dmxDecoder *decoder){
+    if(decoder->state == DMX_DECODER_ALTERNATE){
+        decoder->alternatePacket = decoder->publishAlternate(decoder->context, decoder->alternatePacket, decoder->length);
+    } else{
+        decoder->stats.frames++;
+        if(decoder->length < DMX_PACKET_SIZE){
+            decoder->stats.shortFrames++;
+        }
+        decoder->packet = decoder->publish(decoder->context, decoder->packet, decoder->length);
+    }
+    decoder->length = 0;
+}
+
+/**
+ * @brief Feeds a break (reset) into the decoder.
+ *
+ * @note A frame shorter than 512 slots is complete once the next break arrives.
+ * @param decoder The decoder.
+ * @return void
+ */
+void dmxDecoderBreak(dmxDecoder *decoder){
+    if((decoder->state == DMX_DECODER_SLOTS || decoder->state == DMX_DECODER_ALTERNATE) && decoder->length > 1){
+        publishFrame(decoder); //short frame
+    }
+
+    decoder->stats.breaks++;
+    decoder->state = DMX_DECODER_START_CODE;
+    decoder->length = 0;
+}
+
+/**
+ * @brief Feeds received bytes into the decoder.
+ *
+ * @note Slots are copied in one block per call, a full frame is published with its 512th slot.
+ * @param decoder The decoder.
+ * @param data Received bytes in wire order.
+ * @param length Number of bytes.
+ * @return void
+ */
+void dmxDecoderBytes(dmxDecoder *decoder, const uint8_t *data, size_t length){
+    while(length > 0){
+        switch(decoder->state){
+            case DMX_DECODER_START_CODE:
+                if(data[0] != 0x00){
+                    decoder->stats.alternateFrames++;
+                    if(decoder->alternatePacket == NULL){
+                        decoder->state = DMX_DECODER_IGNORE;
+                        return;
+                    }
+                    decoder->alternatePacket[0] = data[0];
+                    decoder->state = DMX_DECODER_ALTERNATE;
+                } else{
+                    decoder->packet[0] = data[0];
+                    decoder->state = DMX_DECODER_SLOTS;
+                }
+                decoder->length = 1;
+                data++;
+                length--;
+                break;
+            case DMX_DECODER_SLOTS:
+            case DMX_DECODER_ALTERNATE: {
+                uint8_t *packet = decoder->state == DMX_DECODER_SLOTS ? decoder->packet : decoder->alternatePacket;
+                size_t free = DMX_PACKET_SIZE - decoder->length;
+                size_t count = length < free ? length : free;
+                memcpy(&packet[decoder->length], data, count);
+                decoder->length += count;
+                data += count;
+                length -= count;
+
+                if(decoder->length == DMX_PACKET_SIZE){
+                    dmxDecoderState next = decoder->state == DMX_DECODER_SLOTS ? DMX_DECODER_FULL : DMX_DECODER_IGNORE;
+                    publishFrame(decoder); //full frame, don't wait for the next break
+                    decoder->state = next;
+                }
+                break;
+            }
+            case DMX_DECODER_FULL:
+                decoder->stats.longFrames++;
+                decoder->state = DMX_DECODER_IGNORE;
+                return;
+            case DMX_DECODER_WAIT_BREAK:
+            case DMX_DECODER_IGNORE:
+            default:
+                return;
+        }
+    }
+}
+
+/**
+ * @brief Reports a framing / parity / overflow error, the frame in progress is dropped.
+ *
+ * @param decoder The decoder.
+ * @return void
+ */
+void dmxDecoderError(dmxDecoder *decoder){
+    decoder->stats.errors++;
+    decoder->state = DMX_DECODER_WAIT_BREAK;
+    decoder->length = 0;
+}
+
+/**
+ * @brief Drops the frame in progress and continues with another packet, e.g. after the buffer was published elsewhere.
+ *
+ * @note The decoder waits for the next break afterwards, the stats are kept.
+ * @param decoder The decoder.
+ * @param packet Buffer of at least 513 bytes for the next frame.
+ * @return void
+ */
+void dmxDecoderRestart(dmxDecoder *decoder, uint8_t *packet){
+    decoder->packet = packet;
+    decoder->state = DMX_DECODER_WAIT_BREAK;
+    decoder->length = 0;
+}
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxDiff.h"
+#include <string.h>
+
+#define DMX_DIFF_BITS (DMX_DIFF_WORDS * 32)
+
+//word loads of byte buffers, the packets are 4 byte aligned
+typedef uint32_t __attribute__((may_alias)) dmxDiffWord;
+
+/**
+ * @brief Internal function to find the next set (or clear) bit of a bitmap.
+ *
+ * @note This function is only expected to be used internally.
+ * @param bits The bitmap.
+ * @param from First bit to check.
+ * @param set true to find a set bit, false to find a clear bit.
+ *
+ * @return index of the bit, DMX_DIFF_BITS if there is none
+ */
+static uint16_t findBit(const uint32_t *bits, uint16_t from, bool set){
+    uint16_t word = from / 32;
+    if(word >= DMX_DIFF_WORDS){
+        return DMX_DIFF_BITS;
+    }
+
+    uint32_t value = (set ? bits[word] : ~bits[word]) & (UINT32_MAX << (from % 32));
+    while(value == 0){
+        if(++word == DMX_DIFF_WORDS){
+            return DMX_DIFF_BITS;
+        }
+        value = set ? bits[word] : ~bits[word];
+    }
+    return word * 32 + __builtin_ctz(value);
+}
+
+/**
+ * @brief Internal function to count the changed channels and coalesce them into ranges.
+ *
+ * @note This function is only expected to be used internally.
+ * @note If there are more runs than DMX_DIFF_MAX_RANGES, the last range is extended to the last change.
+ * @param map The map with the bitmap filled in.
+ *
+ * @return number of changed channels
+ */
+static uint16_t finishMap(dmxDirtyMap *map){
+    map->changed = 0;
+    map->rangeCount = 0;
+
+    uint16_t first = findBit(map->bits, 1, true);
+    while(first < DMX_DIFF_BITS){
+        uint16_t end = findBit(map->bits, first, false); //bits above 512 are never set, so every run ends
+        map->changed += end - first;
+
+        if(map->rangeCount < DMX_DIFF_MAX_RANGES){
+            map->ranges[map->rangeCount++] = (dmxDirtyRange) {.first = first, .last = end - 1};
+        } else{
+            map->ranges[DMX_DIFF_MAX_RANGES - 1].last = end - 1;
+        }
+        first = findBit(map->bits, end, true);
+    }
+    return map->changed;
+}
+
+/**
+ * @brief Internal SWAR helper: moves the high bit of every non-zero byte of a word into bits 0 - 3.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Bit n of the result belongs to byte n in memory (little endian).
+ */
+static inline uint32_t changedBytes(uint32_t difference){
+    uint32_t high = (((difference & 0x7F7F7F7F) + 0x7F7F7F7F) | difference) & 0x80808080; //no carries across bytes
+    return (high >> 7 | high >> 14 | high >> 21 | high >> 28) & 0xF;
+}
+
+/**
+ * @brief Compares two packets and records which channels changed.
+ *
+ * @note Compares 8 bytes per step with 32 bit words (SWAR), unchanged blocks cost one branch.
+ *       Only uses general purpose registers, so it is safe in interrupts.
+ * @param packet The new packet: [0] start code, [n] channel n. 4 byte aligned.
+ * @param previous The packet to compare with. 4 byte aligned.
+ * @param length Bytes to compare, start code included (1 - 513). Bytes beyond length count as unchanged.
+ * @param map Filled with the changed channels (the start code is never marked).
+ * @return number of changed channels
+ */
+uint16_t dmxDiffPackets(const uint8_t *packet, const uint8_t *previous, uint16_t length, dmxDirtyMap *map){
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return dmxDiffPacketsScalar(packet, previous, length, map);
+#else
+    const dmxDiffWord *words = (const dmxDiffWord*) packet;
+    const dmxDiffWord *previousWords = (const dmxDiffWord*) previous;
+    uint16_t blocks = length / 8;
+
+    memset(map->bits, 0, sizeof(map->bits));
+    for(uint16_t block = 0; block < blocks; block++){
+        uint32_t lo = words[block * 2] ^ previousWords[block * 2];
+        uint32_t hi = words[block * 2 + 1] ^ previousWords[block * 2 + 1];
+        if((lo | hi) == 0){
+            continue;
+        }
+        map->bits[block / 4] |= (changedBytes(lo) | changedBytes(hi) << 4) << (block % 4 * 8);
+    }
+
+    for(uint16_t index = blocks * 8; index < length; index++){
+        if(packet[index] != previous[index]){
+            map->bits[index / 32] |= 1u << (index % 32);
+        }
+    }
+    map->bits[0] &= ~1u; //start code
+
+    return finishMap(map);
+#endif
+}
+
+/**
+ * @brief Byte by byte reference of dmxDiffPackets(), same result.
+ *
+ * @param packet The new packet: [0] start code, [n] channel n.
+ * @param previous The packet to compare with.
+ * @param length Bytes to compare, start code included (1 - 513).
+ * @param map Filled with the changed channels.
+ * @return number of changed channels
+ */
+uint16_t dmxDiffPacketsScalar(const uint8_t *packet, const uint8_t *previous, uint16_t length, dmxDirtyMap *map){
+    memset(map->bits, 0, sizeof(map->bits));
+    for(uint16_t index = 1; index < length; index++){
+        if(packet[index] != previous[index]){
+            map->bits[index / 32] |= 1u << (index % 32);
+        }
+    }
+    return finishMap(map);
+}
+
+/**
+ * @brief Marks every channel of a packet as changed, e.g. for the first frame.
+ *
+ * @param map The map to fill.
+ * @param length Packet length, start code included (1 - 513).
+ * @return void
+ */
+void dmxDiffMarkAll(dmxDirtyMap *map, uint16_t length){
+    memset(map->bits, 0, sizeof(map->bits));
+    for(uint16_t index = 1; index < length; index++){
+        map->bits[index / 32] |= 1u << (index % 32);
+    }
+    finishMap(map);
+}
+
+/**
+ * @brief Checks if any channel of a range changed.
+ *
+ * @param map The map.
+ * @param first First channel of the range (1 - 512)
+ * @param last Last channel of the range (first - 512)
+ * @return true if at least one channel in first - last changed
+ */
+bool dmxDirtyAny(const dmxDirtyMap *map, uint16_t first, uint16_t last){
+    return findBit(map->bits, first, true) <= last;
+}
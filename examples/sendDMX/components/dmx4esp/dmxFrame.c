@@ -0,0 +1,140 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxFrame.h"
+#include <string.h>
+
+/**
+ * @brief Clears a transmit frame (blackout) and resets its sequence counters.
+ *
+ * @param frame Pointer to the frame to initialize.
+ * @return void
+ */
+void dmxTxFrameInit(dmxTxFrame *frame){
+    memset(frame->slots, 0, DMX_MAX_SLOTS);
+    atomic_init(&frame->changeSeq, 0);
+    atomic_init(&frame->bulkSeq, 0);
+}
+
+/**
+ * @brief Lock-free write of a single slot.
+ *
+ * @note Safe to call from any number of tasks concurrently, no kernel call involved.
+ *       A byte store can't tear, so the send task only needs to know that something changed.
+ * @param frame Pointer to the shared frame.
+ * @param index Slot index (0 - 511)
+ * @param value The dmx value (0 - 255)
+ * @return void
+ */
+void dmxTxFrameSetSlot(dmxTxFrame *frame, uint16_t index, uint8_t value){
+    __atomic_store_n(&frame->slots[index], value, __ATOMIC_RELAXED);
+    atomic_fetch_add_explicit(&frame->changeSeq, 1, memory_order_release);
+}
+
+/**
+ * @brief Starts a multi slot write, frames snapshotted until dmxTxFrameEndBulk() keep the previous data.
+ *
+ * @note Bulk writers have to be serialized by the caller (only one bulk write at a time),
+ *       single slot writes may still run concurrently.
+ * @param frame Pointer to the shared frame.
+ * @return void
+ */
+void dmxTxFrameBeginBulk(dmxTxFrame *frame){
+    atomic_fetch_add_explicit(&frame->bulkSeq, 1, memory_order_relaxed); //odd -> write in progress
+    atomic_thread_fence(memory_order_release);
+}
+
+/**
+ * @brief Copies a range of slots into the frame, only valid between begin and end of a bulk write.
+ *
+ * @param frame Pointer to the shared frame.
+ * @param index First slot index (0 - 511)
+ * @param data Pointer to the values to copy.
+ * @param length Number of slots, index + length must not exceed 512.
+ * @return void
+ */
+void dmxTxFrameWriteBulk(dmxTxFrame *frame, uint16_t index, const uint8_t *data, uint16_t length){
+    memcpy(&frame->slots[index], data, length);
+}
+
+/**
+ * @brief Finishes a multi slot write and makes it visible to the send task as a whole.
+ *
+ * @param frame Pointer to the shared frame.
+ * @return void
+ */
+void dmxTxFrameEndBulk(dmxTxFrame *frame){
+    atomic_fetch_add_explicit(&frame->bulkSeq, 1, memory_order_release); //even -> consistent again
+    atomic_fetch_add_explicit(&frame->changeSeq, 1, memory_order_release);
+}
+
+/**
+ * @brief Checks whether a multi slot write is in progress.
+ *
+ * @note Single slot writes made meanwhile become visible with dmxTxFrameEndBulk() at the earliest.
+ * @param frame Pointer to the shared frame.
+ * @return true between dmxTxFrameBeginBulk() and dmxTxFrameEndBulk()
+ */
+bool dmxTxFrameInBulk(dmxTxFrame *frame){
+    return atomic_load_explicit(&frame->bulkSeq, memory_order_acquire) & 1;
+}
+
+/**
+ * @brief Copies the frame into a private buffer if it changed since the last successful snapshot.
+ *
+ * @note Never blocks. If a bulk write is in progress or overlapped the copy, the snapshot is
+ *       rejected and the caller keeps transmitting its previous buffer; the change is picked up
+ *       at the next frame boundary because lastChangeSeq is only updated on success.
+ * @param frame Pointer to the shared frame.
+ * @param destination 512 bytes long buffer owned by the caller.
+ * @param lastChangeSeq In/out: change sequence of the caller's previous snapshot.
+ * @return true if destination now holds a new consistent frame, false otherwise.
+ */
+bool dmxTxFrameSnapshot(dmxTxFrame *frame, uint8_t *destination, uint32_t *lastChangeSeq){
+    uint32_t changeSeq = atomic_load_explicit(&frame->changeSeq, memory_order_acquire);
+    if(changeSeq == *lastChangeSeq){
+        return false; //nothing new
+    }
+
+    uint32_t bulkSeq = atomic_load_explicit(&frame->bulkSeq, memory_order_acquire);
+    if(bulkSeq & 1){
+        return false; //bulk write in progress
+    }
+
+    memcpy(destination, frame->slots, DMX_MAX_SLOTS);
+
+    atomic_thread_fence(memory_order_acquire);
+    if(atomic_load_explicit(&frame->bulkSeq, memory_order_relaxed) != bulkSeq){
+        return false; //a bulk write overlapped the copy
+    }
+
+    *lastChangeSeq = changeSeq;
+    return true;
+}
+
+/**
+ * @brief Returns the break-to-break period a transmitter can keep up for the given settings.
+ *
+ * @note The requested rate is limited by the time the frame takes on the wire
+ *       (break + mark after break + start code + slots) and the minimum break-to-break time.
+ * @param rate Requested refresh rate in Hz.
+ * @param slotCount Number of slots per frame, without the start code (24 - 512)
+ * @param breakUs Duration of the break in µs.
+ * @param markUs Duration of the mark after break in µs.
+ * @return frame period in µs
+ */
+uint32_t dmxFramePeriodUs(uint16_t rate, uint16_t slotCount, uint32_t breakUs, uint32_t markUs){
+    uint32_t period = 1000000 / rate;
+    uint32_t wireTime = breakUs + markUs + (slotCount + 1) * DMX_SLOT_US;
+
+    if(period < wireTime){
+        period = wireTime;
+    }
+    if(period < DMX_MIN_BREAK_TO_BREAK_US){
+        period = DMX_MIN_BREAK_TO_BREAK_US;
+    }
+    return period;
+}
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_RX_BUFFER_H
+#define DMX_RX_BUFFER_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dmxDiff.h"
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+
+#define DMX_RX_BUFFERS 3 // triple buffering: latest frame, frame being decoded, frame held by a reader
+
+/**
+ * @brief One received frame. Never changes while a reader holds it.
+ */
+typedef struct dmxRxFrame {
+    uint8_t packet[513] __attribute__((aligned(4))); // [0] start code, [n] channel n, slots the frame didn't contain are 0
+    uint16_t length; // bytes received, start code included (0 before the first frame)
+    uint32_t sequence; // increments by one per published frame, 0 before the first frame
+    int64_t timestamp; // µs, time the frame was complete
+    dmxDirtyMap changes; // channels that differ from the previously published frame (all of them in the first frame)
+    atomic_uint readers; // internal, number of readers holding the frame
+} dmxRxFrame;
+
+/**
+ * @brief Receive frames shared by the decoder (single writer) and any number of readers.
+ *
+ * @note The decoder publishes complete frames by switching an index, readers take a reference
+ *       on the latest frame instead of copying it. No locks on either side.
+ */
+typedef struct dmxRxBuffer {
+    dmxRxFrame frames[DMX_RX_BUFFERS];
+    uint8_t scratch[513]; // decodes into this while readers hold every other frame, never published
+    atomic_uint latest; // index of the latest complete frame
+    uint8_t writing; // index of the frame being decoded (DMX_RX_BUFFERS: scratch), only used by the writer
+    uint32_t sequence;
+    uint32_t dropped; // frames not published because readers held every other frame
+} dmxRxBuffer;
+
+void dmxRxBufferInit(dmxRxBuffer *buffer);
+
+uint8_t* dmxRxBufferWritePacket(dmxRxBuffer *buffer);
+uint8_t* dmxRxBufferPublish(dmxRxBuffer *buffer, uint16_t length, int64_t timestamp);
+
+const dmxRxFrame* dmxRxBufferAcquire(dmxRxBuffer *buffer);
+void dmxRxBufferRelease(dmxRxBuffer *buffer, const dmxRxFrame *frame);
+
+/**
+ * @brief Returns the latest complete frame without taking a reference.
+ *
+ * @note The frame isn't held and its buffer can be reused for a newer frame while it's read, only single slots can't tear.
+ *       Use dmxRxBufferAcquire() to read several slots consistently.
+ */
+static inline const dmxRxFrame* dmxRxBufferLatest(dmxRxBuffer *buffer){
+    return &buffer->frames[atomic_load_explicit(&buffer->latest, memory_order_acquire)];
+}
+
+#endif
@@ -32,10 +32,12 @@ void sequence1(){
 
     waitMS(2000);
 
-    //Purple Hue 
+    //Purple Hue, the transaction makes sure all three colors change in the same frame
+    dmxBegin();
     sendAddress(7, 102);
     sendAddress(8, 92);
     sendAddress(9, 231);
+    dmxCommit();
 
     waitMS(5000);
 
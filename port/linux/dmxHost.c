@@ -0,0 +1,1240 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define _GNU_SOURCE
+#include "dmxHost.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_intr_alloc.h"
+#include "driver/gpio.h"
+#include "hal/uart_ll.h"
+#include "soc/uart_periph.h"
+#include "sdkconfig.h"
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOST_LINE_EVENTS 16384 // symbols in flight per line (~30 frames)
+#define HOST_MAX_DISPATCH 16 // handler calls per event before the interrupt counts as stuck
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * virtual clock: monotonic time since the first call, in µs, running scale times as fast as the real one
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+static pthread_mutex_t clockLock = PTHREAD_MUTEX_INITIALIZER;
+static int64_t realBaseNs = -1;
+static int64_t virtualBaseNs;
+static double timeScale = 1.0;
+
+static int64_t realNs(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int64_t virtualNs(){
+    pthread_mutex_lock(&clockLock);
+    int64_t now = realNs();
+    if(realBaseNs < 0){
+        realBaseNs = now;
+    }
+    int64_t result = virtualBaseNs + (int64_t) ((now - realBaseNs) * timeScale);
+    pthread_mutex_unlock(&clockLock);
+    return result;
+}
+
+/**
+ * @brief Internal function to convert a virtual time into an absolute CLOCK_MONOTONIC deadline.
+ *
+ * @note This function is only expected to be used internally.
+ * @param timeUs Virtual time (µs)
+ * @return the deadline
+ */
+static struct timespec realDeadline(int64_t timeUs){
+    pthread_mutex_lock(&clockLock);
+    if(realBaseNs < 0){
+        realBaseNs = realNs();
+    }
+    int64_t ns = realBaseNs + (int64_t) ((timeUs * 1000 - virtualBaseNs) / timeScale);
+    pthread_mutex_unlock(&clockLock);
+
+    struct timespec ts = {.tv_sec = ns / 1000000000, .tv_nsec = ns % 1000000000};
+    return ts;
+}
+
+/**
+ * @brief Changes the speed of the virtual clock, 0.5 runs it at half the real speed.
+ *
+ * @note  Slowing the clock down gives the simulated tasks more real time for the same timing, e.g. on a loaded host.
+ *        Set it before creating instances, running waits keep their real deadline.
+ * @param scale Virtual seconds per real second (> 0).
+ * @return void
+ */
+void dmxHostSetTimeScale(double scale){
+    if(scale <= 0){
+        return;
+    }
+    pthread_mutex_lock(&clockLock);
+    int64_t now = realNs();
+    if(realBaseNs >= 0){
+        virtualBaseNs += (int64_t) ((now - realBaseNs) * timeScale);
+    }
+    realBaseNs = now;
+    timeScale = scale;
+    pthread_mutex_unlock(&clockLock);
+}
+
+/**
+ * @brief Sleeps the calling thread until the virtual clock reached the given time.
+ *
+ * @param timeUs Virtual time (µs), see esp_timer_get_time().
+ * @return void
+ */
+void dmxHostSleepUntil(int64_t timeUs){
+    struct timespec deadline = realDeadline(timeUs);
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR){
+    }
+}
+
+int64_t esp_timer_get_time(void){
+    return virtualNs() / 1000;
+}
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void){
+    return (esp_cpu_cycle_count_t) (virtualNs() * CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ / 1000);
+}
+
+static void initCondition(pthread_cond_t *condition){
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    pthread_cond_init(condition, &attributes);
+    pthread_condattr_destroy(&attributes);
+}
+
+/**
+ * @brief Internal function to wait on a condition until a virtual deadline.
+ *
+ * @note This function is only expected to be used internally.
+ * @param condition Condition (CLOCK_MONOTONIC, see initCondition()).
+ * @param mutex Mutex locked by the caller.
+ * @param deadlineUs Virtual time (µs), INT64_MAX waits without timeout.
+ * @return false once the deadline passed
+ */
+static bool waitUntil(pthread_cond_t *condition, pthread_mutex_t *mutex, int64_t deadlineUs){
+    if(deadlineUs == INT64_MAX){
+        pthread_cond_wait(condition, mutex);
+        return true;
+    }
+    if(esp_timer_get_time() >= deadlineUs){
+        return false;
+    }
+    struct timespec deadline = realDeadline(deadlineUs);
+    return pthread_cond_timedwait(condition, mutex, &deadline) != ETIMEDOUT;
+}
+
+static int64_t tickDeadline(TickType_t ticks){
+    return ticks == portMAX_DELAY ? INT64_MAX : esp_timer_get_time() + (int64_t) ticks * portTICK_PERIOD_MS * 1000;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * tasks & notifications
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+struct hostTask {
+    pthread_t thread;
+    TaskFunction_t function;
+    void *parameters;
+    pthread_mutex_t lock;
+    pthread_cond_t condition;
+    uint32_t value;
+    bool pending; //notification not taken yet
+    bool deleted; //exits at its next wait
+};
+
+static __thread struct hostTask *currentTask;
+
+static struct hostTask* newTask(TaskFunction_t function, void *parameters){
+    struct hostTask *task = calloc(1, sizeof(struct hostTask));
+    if(task == NULL){
+        return NULL;
+    }
+    task->function = function;
+    task->parameters = parameters;
+    pthread_mutex_init(&task->lock, NULL);
+    initCondition(&task->condition);
+    return task;
+}
+
+/**
+ * @brief Internal function to get the task of the calling thread, threads not created by xTaskCreate() become one.
+ *
+ * @note This function is only expected to be used internally.
+ * @return the task
+ */
+static struct hostTask* thisTask(){
+    if(currentTask == NULL){
+        currentTask = newTask(NULL, NULL);
+        if(currentTask == NULL){
+            abort();
+        }
+        currentTask->thread = pthread_self();
+    }
+    return currentTask;
+}
+
+static void* taskEntry(void *parameters){
+    currentTask = parameters;
+    currentTask->function(currentTask->parameters);
+    return NULL;
+}
+
+//called with task->lock held, FreeRTOS deletes a blocked task right away
+static void exitIfDeleted(struct hostTask *task){
+    if(task->deleted){
+        pthread_mutex_unlock(&task->lock);
+        pthread_exit(NULL);
+    }
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core){
+    (void) stackDepth;
+    (void) priority;
+    (void) core;
+    struct hostTask *task = newTask(function, parameters);
+    if(task == NULL){
+        return pdFAIL;
+    }
+    if(handle != NULL){
+        *handle = task;
+    }
+    if(pthread_create(&task->thread, NULL, taskEntry, task) != 0){
+        free(task);
+        if(handle != NULL){
+            *handle = NULL;
+        }
+        return pdFAIL;
+    }
+    pthread_setname_np(task->thread, name);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *handle){
+    return xTaskCreatePinnedToCore(function, name, stackDepth, parameters, priority, handle, tskNO_AFFINITY);
+}
+
+/**
+ * @brief Deletes a task.
+ *
+ * @note  The thread ends at its next blocking call (notification wait / delay), this waits for it.
+ *        A task never blocking can't be deleted by another one.
+ * @param task The task, NULL for the calling one.
+ * @return void
+ */
+void vTaskDelete(TaskHandle_t task){
+    if(task == NULL || task == currentTask){
+        struct hostTask *self = thisTask();
+        currentTask = NULL;
+        pthread_detach(self->thread);
+        free(self);
+        pthread_exit(NULL);
+    }
+
+    pthread_mutex_lock(&task->lock);
+    task->deleted = true;
+    pthread_cond_broadcast(&task->condition);
+    pthread_mutex_unlock(&task->lock);
+    pthread_join(task->thread, NULL);
+    pthread_mutex_destroy(&task->lock);
+    pthread_cond_destroy(&task->condition);
+    free(task);
+}
+
+void vTaskDelay(TickType_t ticks){
+    struct hostTask *task = thisTask();
+    int64_t deadline = tickDeadline(ticks);
+
+    pthread_mutex_lock(&task->lock);
+    while(waitUntil(&task->condition, &task->lock, deadline)){
+        exitIfDeleted(task);
+    }
+    exitIfDeleted(task);
+    pthread_mutex_unlock(&task->lock);
+}
+
+TickType_t xTaskGetTickCount(void){
+    return (TickType_t) (esp_timer_get_time() / (portTICK_PERIOD_MS * 1000));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void){
+    return thisTask();
+}
+
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action){
+    BaseType_t result = pdPASS;
+
+    pthread_mutex_lock(&task->lock);
+    switch(action){
+        case eNoAction:
+            break;
+        case eSetBits:
+            task->value |= value;
+            break;
+        case eIncrement:
+            task->value++;
+            break;
+        case eSetValueWithOverwrite:
+            task->value = value;
+            break;
+        case eSetValueWithoutOverwrite:
+            if(task->pending){
+                result = pdFAIL;
+            } else{
+                task->value = value;
+            }
+            break;
+    }
+    task->pending = true;
+    pthread_cond_broadcast(&task->condition);
+    pthread_mutex_unlock(&task->lock);
+    return result;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *higherPriorityTaskWoken){
+    if(higherPriorityTaskWoken != NULL){
+        *higherPriorityTaskWoken = pdTRUE;
+    }
+    return xTaskNotify(task, value, action);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t *value, TickType_t ticks){
+    struct hostTask *task = thisTask();
+    int64_t deadline = tickDeadline(ticks);
+
+    pthread_mutex_lock(&task->lock);
+    if(!task->pending){
+        task->value &= ~clearOnEntry;
+    }
+    while(!task->pending && !task->deleted && waitUntil(&task->condition, &task->lock, deadline)){
+    }
+    exitIfDeleted(task);
+
+    if(value != NULL){
+        *value = task->value;
+    }
+    BaseType_t result = task->pending ? pdTRUE : pdFALSE;
+    if(task->pending){
+        task->value &= ~clearOnExit;
+        task->pending = false;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return result;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * queues, mutexes & critical sections
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+struct hostQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t condition; //broadcast on every send / receive
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t items[];
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize){
+    struct hostQueue *queue = calloc(1, sizeof(struct hostQueue) + (size_t) length * itemSize);
+    if(queue == NULL){
+        return NULL;
+    }
+    pthread_mutex_init(&queue->lock, NULL);
+    initCondition(&queue->condition);
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks){
+    int64_t deadline = tickDeadline(ticks);
+
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == queue->length && waitUntil(&queue->condition, &queue->lock, deadline)){
+    }
+    if(queue->count == queue->length){
+        pthread_mutex_unlock(&queue->lock);
+        return pdFAIL;
+    }
+    memcpy(&queue->items[(size_t) ((queue->head + queue->count) % queue->length) * queue->itemSize], item, queue->itemSize);
+    queue->count++;
+    pthread_cond_broadcast(&queue->condition);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higherPriorityTaskWoken){
+    BaseType_t result = xQueueSend(queue, item, 0);
+    if(result == pdPASS && higherPriorityTaskWoken != NULL){
+        *higherPriorityTaskWoken = pdTRUE;
+    }
+    return result;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks){
+    int64_t deadline = tickDeadline(ticks);
+
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == 0 && waitUntil(&queue->condition, &queue->lock, deadline)){
+    }
+    if(queue->count == 0){
+        pthread_mutex_unlock(&queue->lock);
+        return pdFAIL;
+    }
+    memcpy(item, &queue->items[(size_t) queue->head * queue->itemSize], queue->itemSize);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_broadcast(&queue->condition);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue){
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue){
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->condition);
+    free(queue);
+}
+
+struct hostSemaphore {
+    pthread_mutex_t mutex;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void){
+    struct hostSemaphore *semaphore = calloc(1, sizeof(struct hostSemaphore));
+    if(semaphore != NULL){
+        pthread_mutex_init(&semaphore->mutex, NULL);
+    }
+    return semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks){
+    if(ticks == portMAX_DELAY){
+        return pthread_mutex_lock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+    }
+    if(ticks == 0){
+        return pthread_mutex_trylock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+    }
+    struct timespec deadline = realDeadline(tickDeadline(ticks));
+    return pthread_mutex_clocklock(&semaphore->mutex, CLOCK_MONOTONIC, &deadline) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore){
+    return pthread_mutex_unlock(&semaphore->mutex) == 0 ? pdTRUE : pdFALSE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore){
+    pthread_mutex_destroy(&semaphore->mutex);
+    free(semaphore);
+}
+
+void dmxHostMuxInit(portMUX_TYPE *mux){
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&mux->mutex, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+void dmxHostMuxLock(portMUX_TYPE *mux){
+    pthread_mutex_lock(&mux->mutex);
+}
+
+void dmxHostMuxUnlock(portMUX_TYPE *mux){
+    pthread_mutex_unlock(&mux->mutex);
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * esp_timer: one thread runs all callbacks in deadline order, like the esp_timer task
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    bool skipUnhandled;
+    bool armed;
+    int64_t alarm; //virtual µs
+    uint64_t period; //0: one-shot
+    struct esp_timer *next;
+};
+
+static pthread_once_t timerOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t timerLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t timerCondition; //timers changed or a callback returned
+static struct esp_timer *timers;
+static struct esp_timer *runningTimer; //callback in progress
+static pthread_t timerThread;
+
+static void* timerTask(void *parameters){
+    (void) parameters;
+    pthread_mutex_lock(&timerLock);
+    for(;;){
+        struct esp_timer *due = NULL;
+        for(struct esp_timer *timer = timers; timer != NULL; timer = timer->next){
+            if(timer->armed && (due == NULL || timer->alarm < due->alarm)){
+                due = timer;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        if(due == NULL || due->alarm > now){
+            waitUntil(&timerCondition, &timerLock, due != NULL ? due->alarm : INT64_MAX);
+            continue;
+        }
+
+        if(due->period == 0){
+            due->armed = false;
+        } else{
+            due->alarm += due->period;
+            if(due->skipUnhandled && due->alarm <= now){
+                due->alarm = now + due->period;
+            }
+        }
+        runningTimer = due;
+        esp_timer_cb_t callback = due->callback;
+        void *arg = due->arg;
+        pthread_mutex_unlock(&timerLock);
+        callback(arg);
+        pthread_mutex_lock(&timerLock);
+        runningTimer = NULL;
+        pthread_cond_broadcast(&timerCondition);
+    }
+    return NULL;
+}
+
+static void startTimerTask(){
+    initCondition(&timerCondition);
+    pthread_create(&timerThread, NULL, timerTask, NULL);
+    pthread_setname_np(timerThread, "esp_timer");
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle){
+    if(args == NULL || args->callback == NULL || handle == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct esp_timer *timer = calloc(1, sizeof(struct esp_timer));
+    if(timer == NULL){
+        return ESP_ERR_NO_MEM;
+    }
+    timer->callback = args->callback;
+    timer->arg = args->arg;
+    timer->skipUnhandled = args->skip_unhandled_events;
+
+    pthread_once(&timerOnce, startTimerTask);
+    pthread_mutex_lock(&timerLock);
+    timer->next = timers;
+    timers = timer;
+    pthread_mutex_unlock(&timerLock);
+    *handle = timer;
+    return ESP_OK;
+}
+
+static esp_err_t startTimer(esp_timer_handle_t timer, uint64_t timeoutUs, uint64_t periodUs){
+    if(timer == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timerLock);
+    if(timer->armed){
+        pthread_mutex_unlock(&timerLock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm = esp_timer_get_time() + (int64_t) timeoutUs;
+    timer->period = periodUs;
+    timer->armed = true;
+    pthread_cond_broadcast(&timerCondition);
+    pthread_mutex_unlock(&timerLock);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs){
+    return startTimer(timer, timeoutUs, 0);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs){
+    return startTimer(timer, periodUs, periodUs);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer){
+    if(timer == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timerLock);
+    esp_err_t result = timer->armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    pthread_mutex_unlock(&timerLock);
+    return result;
+}
+
+/**
+ * @brief Deletes a stopped timer.
+ *
+ * @note  Waits for a running callback of the timer, unless called from it.
+ * @param timer The timer.
+ * @return ESP_OK on success
+ */
+esp_err_t esp_timer_delete(esp_timer_handle_t timer){
+    if(timer == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&timerLock);
+    if(timer->armed){
+        pthread_mutex_unlock(&timerLock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    for(struct esp_timer **link = &timers; *link != NULL; link = &(*link)->next){
+        if(*link == timer){
+            *link = timer->next;
+            break;
+        }
+    }
+    while(runningTimer == timer && !pthread_equal(pthread_self(), timerThread)){
+        pthread_cond_wait(&timerCondition, &timerLock);
+    }
+    pthread_mutex_unlock(&timerLock);
+    free(timer);
+    return ESP_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * GPIO & interrupts
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+static int gpioLevels[GPIO_NUM_MAX];
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode){
+    (void) mode;
+    return pin >= 0 && pin < GPIO_NUM_MAX ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level){
+    if(pin < 0 || pin >= GPIO_NUM_MAX){
+        return ESP_ERR_INVALID_ARG;
+    }
+    gpioLevels[pin] = level != 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin){
+    return pin >= 0 && pin < GPIO_NUM_MAX ? gpioLevels[pin] : 0;
+}
+
+const uart_signal_conn_t uart_periph_signal[SOC_UART_NUM] = {{.irq = UART_NUM_0}, {.irq = UART_NUM_1}, {.irq = UART_NUM_2}};
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * simulated UARTs & bus
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+typedef struct hostEvent {
+    int64_t time; //end of the symbol on the wire (virtual µs)
+    uint32_t duration; //µs, breaks only
+    uint8_t type; //dmxHostSymbolType
+    uint8_t value;
+} hostEvent;
+
+struct hostUart {
+    uart_port_t port;
+    uint32_t byteUs; //11 bits at 250 kbaud
+    uint32_t bitNs;
+    bool installed; //TX driver
+    //transmitter
+    int peer; //receiver its line is connected to, -1 if none
+    bool inverted; //sending a break
+    int64_t breakStart;
+    int64_t txFreeAt; //last byte written leaves the UART
+    //line into the receiver
+    hostEvent events[HOST_LINE_EVENTS];
+    uint32_t eventHead;
+    uint32_t eventCount;
+    int64_t lineFreeAt;
+    //receiver
+    uint8_t fifo[SOC_UART_FIFO_LEN];
+    uint32_t fifoHead;
+    uint32_t fifoLength;
+    uint32_t rawStatus;
+    uint32_t enabled;
+    uint32_t fullThreshold;
+    uint32_t timeoutBits;
+    int64_t lastByteAt;
+    bool timeoutArmed;
+    intr_handler_t handler;
+    void *handlerArg;
+    dmxHostRxStats rxStats;
+};
+
+struct hostInterrupt {
+    uart_port_t port;
+};
+
+static pthread_once_t busOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t busLock; //recursive, held by the bus thread while it runs interrupt handlers
+static pthread_cond_t busCondition; //new symbols on a line
+static struct hostUart uarts[SOC_UART_NUM];
+
+static bool isPort(uart_port_t port){
+    return port >= 0 && port < SOC_UART_NUM;
+}
+
+static uint32_t interruptStatus(const struct hostUart *uart){
+    uint32_t status = uart->rawStatus;
+    if(uart->fullThreshold > 0 && uart->fifoLength >= uart->fullThreshold){
+        status |= UART_INTR_RXFIFO_FULL; //level triggered, like the FIFO threshold of the UART
+    }
+    return status;
+}
+
+//runs the handler until it cleared every enabled interrupt
+static void dispatch(struct hostUart *uart){
+    for(int i = 0; i < HOST_MAX_DISPATCH && uart->handler != NULL && (interruptStatus(uart) & uart->enabled) != 0; i++){
+        uart->rxStats.interrupts++;
+        uart->handler(uart->handlerArg);
+    }
+}
+
+static void pushFifo(struct hostUart *uart, uint8_t value, int64_t time){
+    if(uart->fifoLength == SOC_UART_FIFO_LEN){
+        uart->rawStatus |= UART_INTR_RXFIFO_OVF;
+        uart->rxStats.overflows++;
+        return;
+    }
+    uart->fifo[(uart->fifoHead + uart->fifoLength) % SOC_UART_FIFO_LEN] = value;
+    uart->fifoLength++;
+    uart->lastByteAt = time;
+    uart->timeoutArmed = true;
+}
+
+static void checkTimeout(struct hostUart *uart, int64_t now){
+    int64_t timeoutNs = (int64_t) uart->timeoutBits * uart->bitNs;
+    if(uart->timeoutArmed && uart->fifoLength > 0 && (uart->lastByteAt * 1000 + timeoutNs) <= now * 1000){
+        uart->rawStatus |= UART_INTR_RXFIFO_TOUT;
+        uart->timeoutArmed = false;
+    }
+}
+
+static void deliver(struct hostUart *uart, const hostEvent *event){
+    switch(event->type){
+        case DMX_HOST_BYTE:
+            uart->rxStats.bytes++;
+            pushFifo(uart, event->value, event->time);
+            break;
+        case DMX_HOST_BREAK:
+            //the UART sees a null byte without stop bit, from one character time on it's a break
+            pushFifo(uart, 0x00, event->time);
+            if(event->duration >= uart->byteUs){
+                uart->rawStatus |= UART_INTR_BRK_DET;
+                uart->rxStats.breaks++;
+            } else{
+                uart->rawStatus |= UART_INTR_FRAM_ERR;
+                uart->rxStats.errors++;
+            }
+            break;
+        case DMX_HOST_FRAMING_ERROR:
+            pushFifo(uart, event->value, event->time);
+            uart->rawStatus |= UART_INTR_FRAM_ERR;
+            uart->rxStats.errors++;
+            break;
+        case DMX_HOST_PARITY_ERROR:
+            pushFifo(uart, event->value, event->time);
+            uart->rawStatus |= UART_INTR_PARITY_ERR;
+            uart->rxStats.errors++;
+            break;
+    }
+}
+
+/**
+ * @brief Internal function to deliver every symbol of a line that ended until now and raise the resulting interrupts.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Called by the bus thread with busLock held. Timeouts are evaluated at the time of every symbol,
+ *       so a late bus thread still sees the same interrupt sequence.
+ * @param uart The receiving UART.
+ * @param now Virtual time (µs)
+ *
+ * @return virtual time of the next symbol / timeout, INT64_MAX if none
+ */
+static int64_t serviceLine(struct hostUart *uart, int64_t now){
+    while(uart->eventCount > 0 && uart->events[uart->eventHead].time <= now){
+        hostEvent event = uart->events[uart->eventHead];
+        uart->eventHead = (uart->eventHead + 1) % HOST_LINE_EVENTS;
+        uart->eventCount--;
+
+        checkTimeout(uart, event.time);
+        dispatch(uart);
+        deliver(uart, &event);
+        dispatch(uart);
+    }
+    checkTimeout(uart, now);
+    dispatch(uart);
+
+    int64_t next = uart->eventCount > 0 ? uart->events[uart->eventHead].time : INT64_MAX;
+    if(uart->timeoutArmed && uart->fifoLength > 0){
+        int64_t timeout = uart->lastByteAt + ((int64_t) uart->timeoutBits * uart->bitNs + 999) / 1000;
+        next = timeout < next ? timeout : next;
+    }
+    return next;
+}
+
+static void* busTask(void *parameters){
+    (void) parameters;
+    pthread_mutex_lock(&busLock);
+    for(;;){
+        int64_t now = esp_timer_get_time();
+        int64_t next = INT64_MAX;
+        for(int port = 0; port < SOC_UART_NUM; port++){
+            int64_t time = serviceLine(&uarts[port], now);
+            next = time < next ? time : next;
+        }
+        waitUntil(&busCondition, &busLock, next);
+    }
+    return NULL;
+}
+
+static void setBaudRate(struct hostUart *uart, uint32_t baudRate, uint32_t bitsPerByte){
+    uart->bitNs = 1000000000 / baudRate;
+    uart->byteUs = (bitsPerByte * uart->bitNs + 999) / 1000;
+}
+
+static void startBus(){
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&busLock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    initCondition(&busCondition);
+
+    for(int port = 0; port < SOC_UART_NUM; port++){
+        uarts[port].port = port;
+        uarts[port].peer = -1;
+        setBaudRate(&uarts[port], 250000, 11);
+    }
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, busTask, NULL);
+    pthread_setname_np(thread, "dmx bus");
+    pthread_detach(thread);
+}
+
+static struct hostUart* lockBus(uart_port_t port){
+    pthread_once(&busOnce, startBus);
+    pthread_mutex_lock(&busLock);
+    return isPort(port) ? &uarts[port] : NULL;
+}
+
+static void unlockBus(){
+    pthread_mutex_unlock(&busLock);
+}
+
+/**
+ * @brief Internal function to append a symbol to a line.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Called with busLock held, which is released while a full line drains.
+ * @param uart The receiving UART.
+ * @param type Symbol type.
+ * @param value Byte value.
+ * @param start Start on the wire (virtual µs), moved behind the previous symbol.
+ * @param duration Length on the wire (µs)
+ *
+ * @return end of the symbol on the wire
+ */
+static int64_t appendSymbol(struct hostUart *uart, uint8_t type, uint8_t value, int64_t start, uint32_t duration){
+    while(uart->eventCount == HOST_LINE_EVENTS){
+        int64_t wait = uart->events[uart->eventHead].time;
+        unlockBus();
+        dmxHostSleepUntil(wait);
+        pthread_mutex_lock(&busLock);
+    }
+
+    start = start > uart->lineFreeAt ? start : uart->lineFreeAt;
+    int64_t end = start + duration;
+    uart->lineFreeAt = end;
+    if(type != DMX_HOST_MARK){
+        hostEvent *event = &uart->events[(uart->eventHead + uart->eventCount) % HOST_LINE_EVENTS];
+        event->time = end;
+        event->duration = duration;
+        event->type = type;
+        event->value = value;
+        uart->eventCount++;
+        pthread_cond_signal(&busCondition);
+    }
+    return end;
+}
+
+uart_dev_t* dmxHostUart(uart_port_t port){
+    pthread_once(&busOnce, startBus);
+    return isPort(port) ? &uarts[port] : NULL;
+}
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config){
+    struct hostUart *uart = lockBus(port);
+    if(uart == NULL || config == NULL || config->baud_rate <= 0){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t stopBits = config->stop_bits == UART_STOP_BITS_2 ? 2 : 1;
+    setBaudRate(uart, config->baud_rate, 1 + 5 + config->data_bits + (config->parity != UART_PARITY_DISABLE) + stopBits);
+    unlockBus();
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts){
+    (void) tx;
+    (void) rx;
+    (void) rts;
+    (void) cts;
+    return isPort(port) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rxBufferSize, int txBufferSize, int queueSize, QueueHandle_t *queue, int flags){
+    (void) rxBufferSize;
+    (void) txBufferSize;
+    (void) queueSize;
+    (void) flags;
+    struct hostUart *uart = lockBus(port);
+    if(uart == NULL || queue != NULL){
+        unlockBus();
+        return uart == NULL ? ESP_ERR_INVALID_ARG : ESP_ERR_NOT_SUPPORTED; //no event queue on the host
+    }
+    esp_err_t result = uart->installed || uart->handler != NULL ? ESP_FAIL : ESP_OK;
+    uart->installed = true;
+    unlockBus();
+    return result;
+}
+
+esp_err_t uart_driver_delete(uart_port_t port){
+    struct hostUart *uart = lockBus(port);
+    if(uart != NULL){
+        uart->installed = false;
+    }
+    unlockBus();
+    return ESP_OK;
+}
+
+bool uart_is_driver_installed(uart_port_t port){
+    struct hostUart *uart = lockBus(port);
+    bool installed = uart != NULL && uart->installed;
+    unlockBus();
+    return installed;
+}
+
+esp_err_t uart_flush_input(uart_port_t port){
+    struct hostUart *uart = lockBus(port);
+    if(uart == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    uart->fifoLength = 0;
+    uart->timeoutArmed = false;
+    unlockBus();
+    return ESP_OK;
+}
+
+/**
+ * @brief Queues bytes on the line of a UART, they leave it back to back after the previous ones.
+ *
+ * @note  Never blocks (the TX ring buffer of the driver is large enough for a frame).
+ * @return number of bytes written, -1 without driver
+ */
+int uart_write_bytes(uart_port_t port, const void *data, size_t length){
+    struct hostUart *uart = lockBus(port);
+    if(uart == NULL || !uart->installed){
+        unlockBus();
+        return -1;
+    }
+
+    const uint8_t *bytes = data;
+    int64_t now = esp_timer_get_time();
+    int64_t start = uart->txFreeAt > now ? uart->txFreeAt : now;
+    if(uart->peer >= 0){
+        for(size_t i = 0; i < length; i++){
+            start = appendSymbol(&uarts[uart->peer], DMX_HOST_BYTE, bytes[i], start, uart->byteUs);
+        }
+    } else{
+        start += (int64_t) length * uart->byteUs;
+    }
+    uart->txFreeAt = start;
+    unlockBus();
+    return (int) length;
+}
+
+esp_err_t uart_wait_tx_done(uart_port_t port, TickType_t ticks){
+    struct hostUart *uart = lockBus(port);
+    if(uart == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    int64_t freeAt = uart->txFreeAt;
+    unlockBus();
+
+    int64_t deadline = tickDeadline(ticks);
+    if(freeAt <= esp_timer_get_time()){
+        return ESP_OK;
+    }
+    if(ticks == 0){
+        return ESP_ERR_TIMEOUT;
+    }
+    dmxHostSleepUntil(freeAt < deadline ? freeAt : deadline);
+    return freeAt <= deadline ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+/**
+ * @brief Inverts the TX line, the time it stays inverted arrives at the receiver as one break symbol.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t uart_set_line_inverse(uart_port_t port, uint32_t inverseMask){
+    struct hostUart *uart = lockBus(port);
+    if(uart == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    bool inverted = (inverseMask & UART_SIGNAL_TXD_INV) != 0;
+    int64_t now = esp_timer_get_time();
+    if(inverted && !uart->inverted){
+        uart->breakStart = now;
+    } else if(!inverted && uart->inverted){
+        if(uart->peer >= 0){
+            appendSymbol(&uarts[uart->peer], DMX_HOST_BREAK, 0x00, uart->breakStart, (uint32_t) (now - uart->breakStart));
+        }
+        uart->txFreeAt = uart->txFreeAt > now ? uart->txFreeAt : now;
+    }
+    uart->inverted = inverted;
+    unlockBus();
+    return ESP_OK;
+}
+
+uint32_t uart_ll_get_intsts_mask(uart_dev_t *hw){
+    pthread_mutex_lock(&busLock);
+    uint32_t status = interruptStatus(hw) & hw->enabled;
+    pthread_mutex_unlock(&busLock);
+    return status;
+}
+
+void uart_ll_clr_intsts_mask(uart_dev_t *hw, uint32_t mask){
+    pthread_mutex_lock(&busLock);
+    hw->rawStatus &= ~mask;
+    pthread_mutex_unlock(&busLock);
+}
+
+void uart_ll_ena_intr_mask(uart_dev_t *hw, uint32_t mask){
+    pthread_mutex_lock(&busLock);
+    hw->enabled |= mask;
+    pthread_cond_signal(&busCondition); //pending interrupts fire now
+    pthread_mutex_unlock(&busLock);
+}
+
+void uart_ll_disable_intr_mask(uart_dev_t *hw, uint32_t mask){
+    pthread_mutex_lock(&busLock);
+    hw->enabled &= ~mask;
+    pthread_mutex_unlock(&busLock);
+}
+
+uint32_t uart_ll_get_rxfifo_len(uart_dev_t *hw){
+    pthread_mutex_lock(&busLock);
+    uint32_t length = hw->fifoLength;
+    pthread_mutex_unlock(&busLock);
+    return length;
+}
+
+void uart_ll_read_rxfifo(uart_dev_t *hw, uint8_t *buffer, uint32_t length){
+    pthread_mutex_lock(&busLock);
+    for(uint32_t i = 0; i < length && hw->fifoLength > 0; i++){
+        buffer[i] = hw->fifo[hw->fifoHead];
+        hw->fifoHead = (hw->fifoHead + 1) % SOC_UART_FIFO_LEN;
+        hw->fifoLength--;
+    }
+    pthread_mutex_unlock(&busLock);
+}
+
+void uart_ll_rxfifo_rst(uart_dev_t *hw){
+    pthread_mutex_lock(&busLock);
+    hw->fifoLength = 0;
+    hw->timeoutArmed = false;
+    pthread_mutex_unlock(&busLock);
+}
+
+void uart_ll_set_rxfifo_full_thr(uart_dev_t *hw, uint16_t threshold){
+    pthread_mutex_lock(&busLock);
+    hw->fullThreshold = threshold;
+    pthread_mutex_unlock(&busLock);
+}
+
+void uart_ll_set_rx_tout(uart_dev_t *hw, uint16_t bits){
+    pthread_mutex_lock(&busLock);
+    hw->timeoutBits = bits;
+    pthread_mutex_unlock(&busLock);
+}
+
+bool uart_ll_is_tx_idle(uart_dev_t *hw){
+    pthread_mutex_lock(&busLock);
+    bool idle = hw->txFreeAt <= esp_timer_get_time();
+    pthread_mutex_unlock(&busLock);
+    return idle;
+}
+
+esp_err_t esp_intr_alloc(int source, int flags, intr_handler_t handler, void *arg, intr_handle_t *handle){
+    (void) flags;
+    struct hostUart *uart = lockBus(source);
+    if(uart == NULL || handler == NULL || handle == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(uart->handler != NULL){
+        unlockBus();
+        return ESP_ERR_NOT_FOUND; //no free interrupt for this source
+    }
+    struct hostInterrupt *interrupt = malloc(sizeof(struct hostInterrupt));
+    if(interrupt == NULL){
+        unlockBus();
+        return ESP_ERR_NO_MEM;
+    }
+    interrupt->port = source;
+    uart->handler = handler;
+    uart->handlerArg = arg;
+    *handle = interrupt;
+    unlockBus();
+    return ESP_OK;
+}
+
+/**
+ * @brief Frees an interrupt, its handler doesn't run anymore once this returned.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t esp_intr_free(intr_handle_t handle){
+    if(handle == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct hostUart *uart = lockBus(handle->port); //the bus thread holds the lock while a handler runs
+    uart->handler = NULL;
+    uart->handlerArg = NULL;
+    unlockBus();
+    free(handle);
+    return ESP_OK;
+}
+
+/* ---------------------------------------------------------------------------------------------------------------------
+ * host control
+ * ------------------------------------------------------------------------------------------------------------------ */
+
+/**
+ * @brief Connects the line of a transmitting UART to a receiving one, like a cable between two transceivers.
+ *
+ * @param txPort The transmitting UART.
+ * @param rxPort The receiving UART, may be the same one for a loopback plug.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxHostConnect(uart_port_t txPort, uart_port_t rxPort){
+    struct hostUart *uart = lockBus(txPort);
+    if(uart == NULL || !isPort(rxPort)){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    uart->peer = rxPort;
+    unlockBus();
+    return ESP_OK;
+}
+
+/**
+ * @brief Disconnects the line of a transmitting UART, it keeps sending into the void.
+ *
+ * @param txPort The transmitting UART.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxHostDisconnect(uart_port_t txPort){
+    struct hostUart *uart = lockBus(txPort);
+    if(uart == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    uart->peer = -1;
+    unlockBus();
+    return ESP_OK;
+}
+
+/**
+ * @brief Puts raw symbols on the line into a receiving UART, e.g. to inject faults.
+ *
+ * @note  The symbols start when the line is free (after symbols sent before, at the earliest now) and arrive
+ *        at the time they end on the wire. Blocks only while the line is full (HOST_LINE_EVENTS symbols).
+ * @param rxPort The receiving UART.
+ * @param symbols The symbols, back to back.
+ * @param count Number of symbols.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxHostWireSend(uart_port_t rxPort, const dmxHostSymbol *symbols, size_t count){
+    struct hostUart *uart = lockBus(rxPort);
+    if(uart == NULL || symbols == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int64_t start = esp_timer_get_time();
+    for(size_t i = 0; i < count; i++){
+        const dmxHostSymbol *symbol = &symbols[i];
+        uint32_t duration = symbol->durationUs;
+        if(duration == 0 && symbol->type != DMX_HOST_BREAK && symbol->type != DMX_HOST_MARK){
+            duration = uart->byteUs;
+        }
+        start = appendSymbol(uart, symbol->type, symbol->value, start, duration);
+    }
+    unlockBus();
+    return ESP_OK;
+}
+
+/**
+ * @brief Returns when the last symbol sent into a receiving UART ends on the wire.
+ *
+ * @param rxPort The receiving UART.
+ * @return virtual time (µs), 0 if nothing was sent yet
+ */
+int64_t dmxHostWireIdleAt(uart_port_t rxPort){
+    struct hostUart *uart = lockBus(rxPort);
+    int64_t idleAt = uart != NULL ? uart->lineFreeAt : 0;
+    unlockBus();
+    return idleAt;
+}
+
+/**
+ * @brief Reads the counters of a simulated receiver.
+ *
+ * @param rxPort The receiving UART.
+ * @param stats Pointer to the stats to fill.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxHostGetRxStats(uart_port_t rxPort, dmxHostRxStats *stats){
+    struct hostUart *uart = lockBus(rxPort);
+    if(uart == NULL || stats == NULL){
+        unlockBus();
+        return ESP_ERR_INVALID_ARG;
+    }
+    *stats = uart->rxStats;
+    unlockBus();
+    return ESP_OK;
+}
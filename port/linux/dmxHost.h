@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_HOST_H
+#define DMX_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "driver/uart.h"
+
+// Linux backend of dmx4esp: the ESP-IDF / FreeRTOS calls of the library are implemented on pthreads,
+// a virtual clock and a simulated RS-485 bus, so src/ compiles unchanged on a host (see port/linux/include).
+//
+// Every UART drives its own line. A line can be connected to the receiver of another UART (or its own),
+// bytes, breaks and errors arrive there at the time they end on the wire. A bus thread delivers them into
+// the 128 byte RX FIFO of the receiver and runs its interrupt handler, just like the UART does.
+
+#define DMX_HOST_BYTE_US 44 // 11 bits at 250 kbaud
+
+typedef enum {
+    DMX_HOST_BYTE, // a byte with two stop bits (DMX_HOST_BYTE_US)
+    DMX_HOST_BREAK, // line low for durationUs, detected as a break from 11 bits (44µs) on, a framing error below
+    DMX_HOST_MARK, // line idle (high) for durationUs
+    DMX_HOST_FRAMING_ERROR, // a byte with a missing stop bit
+    DMX_HOST_PARITY_ERROR // a byte with a parity error (reported by the UART even with parity disabled)
+} dmxHostSymbolType;
+
+/**
+ * @brief One symbol on a simulated line.
+ */
+typedef struct dmxHostSymbol {
+    dmxHostSymbolType type;
+    uint8_t value; // byte value of DMX_HOST_BYTE / DMX_HOST_FRAMING_ERROR / DMX_HOST_PARITY_ERROR
+    uint32_t durationUs; // 0: DMX_HOST_BYTE_US for bytes, required for DMX_HOST_BREAK / DMX_HOST_MARK
+} dmxHostSymbol;
+
+/**
+ * @brief Counters of a simulated receiver.
+ */
+typedef struct dmxHostRxStats {
+    uint32_t bytes; // delivered into the FIFO
+    uint32_t breaks;
+    uint32_t errors; // framing & parity errors
+    uint32_t overflows; // bytes lost on a full FIFO
+    uint32_t interrupts; // handler calls
+} dmxHostRxStats;
+
+esp_err_t dmxHostConnect(uart_port_t txPort, uart_port_t rxPort);
+esp_err_t dmxHostDisconnect(uart_port_t txPort);
+esp_err_t dmxHostWireSend(uart_port_t rxPort, const dmxHostSymbol *symbols, size_t count);
+int64_t dmxHostWireIdleAt(uart_port_t rxPort);
+esp_err_t dmxHostGetRxStats(uart_port_t rxPort, dmxHostRxStats *stats);
+void dmxHostSetTimeScale(double scale);
+void dmxHostSleepUntil(int64_t timeUs);
+
+#endif
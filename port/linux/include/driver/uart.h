@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+typedef enum {UART_NUM_0, UART_NUM_1, UART_NUM_2, UART_NUM_MAX} uart_port_t;
+
+typedef enum {UART_DATA_5_BITS, UART_DATA_6_BITS, UART_DATA_7_BITS, UART_DATA_8_BITS} uart_word_length_t;
+typedef enum {UART_PARITY_DISABLE, UART_PARITY_EVEN = 2, UART_PARITY_ODD} uart_parity_t;
+typedef enum {UART_STOP_BITS_1 = 1, UART_STOP_BITS_1_5, UART_STOP_BITS_2} uart_stop_bits_t;
+typedef enum {UART_HW_FLOWCTRL_DISABLE} uart_hw_flowcontrol_t;
+
+typedef struct {
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+    int source_clk;
+} uart_config_t;
+
+#define UART_PIN_NO_CHANGE (-1)
+
+#define UART_SIGNAL_INV_DISABLE 0
+#define UART_SIGNAL_TXD_INV (1 << 6)
+
+// interrupt bits, as in hal/uart_types.h
+#define UART_INTR_RXFIFO_FULL (1 << 0)
+#define UART_INTR_TXFIFO_EMPTY (1 << 1)
+#define UART_INTR_PARITY_ERR (1 << 2)
+#define UART_INTR_FRAM_ERR (1 << 3)
+#define UART_INTR_RXFIFO_OVF (1 << 4)
+#define UART_INTR_BRK_DET (1 << 7)
+#define UART_INTR_RXFIFO_TOUT (1 << 8)
+
+// host port: the UART sends into the simulated bus (see dmxHost.h), 11 bits per byte at the configured baud rate
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config);
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts);
+esp_err_t uart_driver_install(uart_port_t port, int rxBufferSize, int txBufferSize, int queueSize, QueueHandle_t *queue, int flags);
+esp_err_t uart_driver_delete(uart_port_t port);
+bool uart_is_driver_installed(uart_port_t port);
+esp_err_t uart_flush_input(uart_port_t port);
+int uart_write_bytes(uart_port_t port, const void *data, size_t length);
+esp_err_t uart_wait_tx_done(uart_port_t port, TickType_t ticks);
+esp_err_t uart_set_line_inverse(uart_port_t port, uint32_t inverseMask);
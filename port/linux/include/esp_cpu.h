@@ -0,0 +1,14 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+// CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ cycles per µs of the virtual clock
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_EXEC (1 << 0)
+#define MALLOC_CAP_32BIT (1 << 1)
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+// every capability is plain heap on the host
+static inline void* heap_caps_malloc(size_t size, uint32_t caps){
+    (void) caps;
+    return malloc(size);
+}
+
+static inline void* heap_caps_calloc(size_t count, size_t size, uint32_t caps){
+    (void) caps;
+    return calloc(count, size);
+}
+
+static inline void heap_caps_free(void *pointer){
+    free(pointer);
+}
@@ -0,0 +1,19 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "esp_err.h"
+
+#define ESP_INTR_FLAG_LEVEL1 (1 << 1)
+#define ESP_INTR_FLAG_IRAM (1 << 10)
+
+typedef void (*intr_handler_t)(void *arg);
+typedef struct hostInterrupt *intr_handle_t;
+
+// host port: interrupts of the simulated UARTs run on the bus thread, source is uart_periph_signal[port].irq
+esp_err_t esp_intr_alloc(int source, int flags, intr_handler_t handler, void *arg, intr_handle_t *handle);
+esp_err_t esp_intr_free(intr_handle_t handle);
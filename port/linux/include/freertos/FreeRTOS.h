@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// host port: the FreeRTOS subset dmx4esp uses, tasks are pthreads and ticks are milliseconds of the virtual clock
+// (task.h, queue.h and semphr.h only include this header)
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define portMAX_DELAY ((TickType_t) 0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t) (ms))
+#define configMAX_PRIORITIES 25
+#define tskNO_AFFINITY 0x7FFFFFFF
+#define tskIDLE_PRIORITY 0
+#define portNUM_PROCESSORS 2
+
+typedef struct hostTask *TaskHandle_t;
+typedef struct hostQueue *QueueHandle_t;
+typedef struct hostSemaphore *SemaphoreHandle_t;
+typedef void (*TaskFunction_t)(void *parameters);
+
+typedef enum {eNoAction, eSetBits, eIncrement, eSetValueWithOverwrite, eSetValueWithoutOverwrite} eNotifyAction;
+
+// critical sections are a recursive mutex, the simulated interrupts run on their own thread
+typedef struct {
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+void dmxHostMuxInit(portMUX_TYPE *mux);
+void dmxHostMuxLock(portMUX_TYPE *mux);
+void dmxHostMuxUnlock(portMUX_TYPE *mux);
+
+#define portMUX_INITIALIZE(mux) dmxHostMuxInit(mux)
+#define portENTER_CRITICAL(mux) dmxHostMuxLock(mux)
+#define portEXIT_CRITICAL(mux) dmxHostMuxUnlock(mux)
+#define portENTER_CRITICAL_ISR(mux) dmxHostMuxLock(mux)
+#define portEXIT_CRITICAL_ISR(mux) dmxHostMuxUnlock(mux)
+#define portYIELD_FROM_ISR(yield) ((void) (yield))
+#define taskYIELD() sched_yield()
+
+// tasks (core and priority are ignored)
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t function, const char *name, uint32_t stackDepth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+
+// direct to task notifications
+BaseType_t xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t task, uint32_t value, eNotifyAction action, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xTaskNotifyWait(uint32_t clearOnEntry, uint32_t clearOnExit, uint32_t *value, TickType_t ticks);
+
+// queues
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void *item, BaseType_t *higherPriorityTaskWoken);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+void vQueueDelete(QueueHandle_t queue);
+
+// mutexes
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
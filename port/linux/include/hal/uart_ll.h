@@ -0,0 +1,28 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driver/uart.h"
+
+// host port: registers of a simulated UART, owned by the bus thread
+typedef struct hostUart uart_dev_t;
+
+uart_dev_t* dmxHostUart(uart_port_t port);
+#define UART_LL_GET_HW(port) dmxHostUart(port)
+
+uint32_t uart_ll_get_intsts_mask(uart_dev_t *hw);
+void uart_ll_clr_intsts_mask(uart_dev_t *hw, uint32_t mask);
+void uart_ll_ena_intr_mask(uart_dev_t *hw, uint32_t mask);
+void uart_ll_disable_intr_mask(uart_dev_t *hw, uint32_t mask);
+uint32_t uart_ll_get_rxfifo_len(uart_dev_t *hw);
+void uart_ll_read_rxfifo(uart_dev_t *hw, uint8_t *buffer, uint32_t length);
+void uart_ll_rxfifo_rst(uart_dev_t *hw);
+void uart_ll_set_rxfifo_full_thr(uart_dev_t *hw, uint16_t threshold);
+void uart_ll_set_rx_tout(uart_dev_t *hw, uint16_t bits);
+bool uart_ll_is_tx_idle(uart_dev_t *hw);
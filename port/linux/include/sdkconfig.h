@@ -0,0 +1,11 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// host port: configuration the library reads from the ESP-IDF sdkconfig
+#pragma once
+
+#define CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ 240 // esp_cpu_get_cycle_count() runs at this rate on the virtual clock
+#define CONFIG_FREERTOS_HZ 1000
@@ -0,0 +1,11 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+// host port: a chip with 3 UARTs and neither UHCI DMA nor a parallel LCD peripheral
+#pragma once
+
+#define SOC_UART_NUM 3
+#define SOC_UART_FIFO_LEN 128
@@ -0,0 +1,15 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include "soc/soc_caps.h"
+
+typedef struct {
+    int irq; // interrupt source for esp_intr_alloc(), the port number on the host
+} uart_signal_conn_t;
+
+extern const uart_signal_conn_t uart_periph_signal[SOC_UART_NUM];
@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_DIFF_H
+#define DMX_DIFF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be benchmarked on a host
+
+#define DMX_DIFF_WORDS 17 // bitmap words for packet indices 0 - 512 (bit 0 is the start code, never set)
+#define DMX_DIFF_MAX_RANGES 16
+
+/**
+ * @brief Consecutive changed channels (inclusive).
+ */
+typedef struct dmxDirtyRange {
+    uint16_t first;
+    uint16_t last;
+} dmxDirtyRange;
+
+/**
+ * @brief Slots that changed between two frames, as a bitmap and as coalesced ranges.
+ */
+typedef struct dmxDirtyMap {
+    uint32_t bits[DMX_DIFF_WORDS]; // bit n % 32 of bits[n / 32] is set if channel n changed
+    uint16_t changed; // number of changed channels
+    uint8_t rangeCount;
+    dmxDirtyRange ranges[DMX_DIFF_MAX_RANGES]; // ascending, with more runs the last range covers all remaining ones
+} dmxDirtyMap;
+
+uint16_t dmxDiffPackets(const uint8_t *packet, const uint8_t *previous, uint16_t length, dmxDirtyMap *map);
+uint16_t dmxDiffPacketsScalar(const uint8_t *packet, const uint8_t *previous, uint16_t length, dmxDirtyMap *map);
+void dmxDiffMarkAll(dmxDirtyMap *map, uint16_t length);
+
+bool dmxDirtyAny(const dmxDirtyMap *map, uint16_t first, uint16_t last);
+
+/**
+ * @brief Returns true if a channel (1 - 512) changed.
+ */
+static inline bool dmxDirtyTest(const dmxDirtyMap *map, uint16_t address){
+    return (map->bits[address / 32] >> (address % 32)) & 1;
+}
+
+#endif
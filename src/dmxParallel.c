@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxParallel.h"
+#include <string.h>
+
+//writes one DMX bit (DMX_PARALLEL_OVERSAMPLE samples) and advances the output pointer
+#define EMIT_BIT(out, stride, value) do{ \
+        for(int repeat = 0; repeat < DMX_PARALLEL_OVERSAMPLE; repeat++){ \
+            *(out) = (value); \
+            (out) += (stride); \
+        } \
+    } while(0)
+
+/**
+ * @brief Returns the number of samples of one bit-parallel frame.
+ *
+ * @param slotCount Number of slots per universe, without the start code (1 - 512)
+ * @return (break + mark after break + (start code + slots) * 11 bits + trailing mark) * oversampling
+ */
+size_t dmxParallelFrameSamples(uint16_t slotCount){
+    return (DMX_PARALLEL_BREAK_SAMPLES + DMX_PARALLEL_MARK_SAMPLES + (slotCount + 1) * DMX_PARALLEL_BITS_PER_SLOT + DMX_PARALLEL_IDLE_SAMPLES) * DMX_PARALLEL_OVERSAMPLE;
+}
+
+/**
+ * @brief Returns the time one bit-parallel frame takes on the bus, the trailing mark included.
+ *
+ * @param slotCount Number of slots per universe, without the start code (1 - 512)
+ * @return length of the sample stream (µs)
+ */
+uint32_t dmxParallelFrameUs(uint16_t slotCount){
+    return dmxParallelFrameSamples(slotCount) / DMX_PARALLEL_OVERSAMPLE * DMX_PARALLEL_BIT_US;
+}
+
+/**
+ * @brief Internal 8x8 bit-matrix transpose of two 32 bit words (lane n in byte n).
+ *
+ * @note Three delta swaps (1x1, 2x2, 4x4 blocks), 32 bit only so it's cheap on the esp32 too.
+ *       Afterwards byte n holds bit n of every lane.
+ */
+static inline void transpose8x8(uint32_t *lo, uint32_t *hi){
+    uint32_t x = *lo;
+    uint32_t y = *hi;
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA; x ^= t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA; y ^= t ^ (t << 7);
+
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x ^= t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y ^= t ^ (t << 14);
+
+    t = (x ^ (y << 4)) & 0xF0F0F0F0; x ^= t; y ^= t >> 4;
+
+    *lo = x;
+    *hi = y;
+}
+
+/**
+ * @brief Transposes an 8x8 bit matrix: bit b of out[n] = bit n of in[b].
+ *
+ * @param in 8 bytes, one per lane.
+ * @param out 8 bytes, one per bit position.
+ * @return void
+ */
+void dmxParallelTranspose8x8(const uint8_t in[8], uint8_t out[8]){
+    uint32_t lo = in[0] | in[1] << 8 | in[2] << 16 | (uint32_t) in[3] << 24;
+    uint32_t hi = in[4] | in[5] << 8 | in[6] << 16 | (uint32_t) in[7] << 24;
+
+    transpose8x8(&lo, &hi);
+
+    for(int i = 0; i < 4; i++){
+        out[i] = lo >> (8 * i);
+        out[i + 4] = hi >> (8 * i);
+    }
+}
+
+/**
+ * @brief Encodes one frame of up to 16 universes into bit-parallel samples.
+ *
+ * @note Hot path of the parallel output. Every slot costs one 8x8 transpose per group of 8 universes.
+ *       Sample k occupies dmxParallelSampleBytes(universes) bytes, byte g drives universes 8g - 8g+7.
+ *       Lanes without a universe stay high (mark).
+ * @param packets One packet per universe: [0] start code, [1 - slotCount] slots.
+ * @param universes Number of universes (1 - 16)
+ * @param slotCount Number of slots per universe (1 - 512)
+ * @param samples Output buffer of dmxParallelFrameSamples(slotCount) * dmxParallelSampleBytes(universes) bytes.
+ * @return number of bytes written
+ */
+size_t dmxParallelEncodeFrame(const uint8_t *const packets[], uint8_t universes, uint16_t slotCount, uint8_t *samples){
+    const size_t stride = dmxParallelSampleBytes(universes);
+    const size_t frameSamples = dmxParallelFrameSamples(slotCount);
+
+    for(size_t group = 0; group < stride; group++){
+        const uint8_t *lanes[8];
+        uint8_t idle = 0; //lanes without a universe
+        for(int lane = 0; lane < 8; lane++){
+            size_t universe = group * 8 + lane;
+            lanes[lane] = universe < universes ? packets[universe] : NULL;
+            if(lanes[lane] == NULL){
+                idle |= 1 << lane;
+            }
+        }
+
+        uint8_t *out = samples + group;
+        for(int i = 0; i < DMX_PARALLEL_BREAK_SAMPLES; i++){
+            EMIT_BIT(out, stride, idle);
+        }
+        for(int i = 0; i < DMX_PARALLEL_MARK_SAMPLES; i++){
+            EMIT_BIT(out, stride, 0xFF);
+        }
+
+        for(size_t slot = 0; slot <= slotCount; slot++){
+            uint32_t lo = 0;
+            uint32_t hi = 0;
+            for(int lane = 0; lane < 4; lane++){
+                lo |= (uint32_t) (lanes[lane] != NULL ? lanes[lane][slot] : 0xFF) << (8 * lane);
+                hi |= (uint32_t) (lanes[lane + 4] != NULL ? lanes[lane + 4][slot] : 0xFF) << (8 * lane);
+            }
+
+            transpose8x8(&lo, &hi);
+
+            EMIT_BIT(out, stride, idle); //start bit
+            EMIT_BIT(out, stride, (uint8_t) lo);
+            EMIT_BIT(out, stride, (uint8_t) (lo >> 8));
+            EMIT_BIT(out, stride, (uint8_t) (lo >> 16));
+            EMIT_BIT(out, stride, (uint8_t) (lo >> 24));
+            EMIT_BIT(out, stride, (uint8_t) hi);
+            EMIT_BIT(out, stride, (uint8_t) (hi >> 8));
+            EMIT_BIT(out, stride, (uint8_t) (hi >> 16));
+            EMIT_BIT(out, stride, (uint8_t) (hi >> 24));
+            EMIT_BIT(out, stride, 0xFF); //stop bits
+            EMIT_BIT(out, stride, 0xFF);
+        }
+
+        for(int i = 0; i < DMX_PARALLEL_IDLE_SAMPLES; i++){
+            EMIT_BIT(out, stride, 0xFF);
+        }
+    }
+
+    return frameSamples * stride;
+}
+
+/**
+ * @brief Scalar reference of dmxParallelEncodeFrame(), one bit at a time.
+ *
+ * @note Only used to verify and benchmark the optimized encoder, produces the same bytes.
+ * @param packets One packet per universe: [0] start code, [1 - slotCount] slots.
+ * @param universes Number of universes (1 - 16)
+ * @param slotCount Number of slots per universe (1 - 512)
+ * @param samples Output buffer of dmxParallelFrameSamples(slotCount) * dmxParallelSampleBytes(universes) bytes.
+ * @return number of bytes written
+ */
+size_t dmxParallelEncodeFrameScalar(const uint8_t *const packets[], uint8_t universes, uint16_t slotCount, uint8_t *samples){
+    const size_t stride = dmxParallelSampleBytes(universes);
+    const size_t frameSamples = dmxParallelFrameSamples(slotCount);
+    const size_t frameBits = frameSamples / DMX_PARALLEL_OVERSAMPLE;
+    const size_t firstSlotBit = DMX_PARALLEL_BREAK_SAMPLES + DMX_PARALLEL_MARK_SAMPLES;
+
+    memset(samples, 0, frameSamples * stride);
+
+    for(size_t sample = 0; sample < frameSamples; sample++){
+        size_t dmxBit = sample / DMX_PARALLEL_OVERSAMPLE;
+        for(size_t lane = 0; lane < stride * 8; lane++){
+            int level;
+            if(lane >= universes){
+                level = 1; //unused lanes idle high
+            } else if(dmxBit < DMX_PARALLEL_BREAK_SAMPLES){
+                level = 0;
+            } else if(dmxBit < firstSlotBit){
+                level = 1;
+            } else if(dmxBit >= frameBits - DMX_PARALLEL_IDLE_SAMPLES){
+                level = 1;
+            } else{
+                size_t slot = (dmxBit - firstSlotBit) / DMX_PARALLEL_BITS_PER_SLOT;
+                size_t bit = (dmxBit - firstSlotBit) % DMX_PARALLEL_BITS_PER_SLOT;
+                if(bit == 0){
+                    level = 0; //start bit
+                } else if(bit <= 8){
+                    level = (packets[lane][slot] >> (bit - 1)) & 1;
+                } else{
+                    level = 1; //stop bits
+                }
+            }
+
+            if(level){
+                samples[sample * stride + lane / 8] |= 1 << (lane % 8);
+            }
+        }
+    }
+
+    return frameSamples * stride;
+}
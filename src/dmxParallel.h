@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_PARALLEL_H
+#define DMX_PARALLEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be benchmarked on a host
+
+//bit-parallel encoding: one sample per DMX bit (4µs at 250 kbaud), bit n of a sample drives universe n
+//the break / mark counts below are in DMX bits
+#define DMX_PARALLEL_MAX_UNIVERSES 16
+#define DMX_PARALLEL_BIT_US 4
+#define DMX_PARALLEL_BITS_PER_SLOT 11 // start bit, 8 data bits (LSB first), 2 stop bits
+#define DMX_PARALLEL_BREAK_SAMPLES 26 // 104µs break
+#define DMX_PARALLEL_MARK_SAMPLES 4 // 16µs mark after break
+#define DMX_PARALLEL_IDLE_SAMPLES 2 // trailing mark, the bus holds the last sample between frames
+
+// samples per DMX bit, raise it if the LCD / I2S clock divider of the chip can't go down to 250kHz
+#ifndef DMX_PARALLEL_OVERSAMPLE
+#define DMX_PARALLEL_OVERSAMPLE 1
+#endif
+
+/**
+ * @brief Returns the number of bytes per sample (1 for up to 8 universes, 2 for up to 16).
+ */
+static inline size_t dmxParallelSampleBytes(uint8_t universes){
+    return (universes + 7) / 8;
+}
+
+size_t dmxParallelFrameSamples(uint16_t slotCount);
+uint32_t dmxParallelFrameUs(uint16_t slotCount);
+
+void dmxParallelTranspose8x8(const uint8_t in[8], uint8_t out[8]);
+
+size_t dmxParallelEncodeFrame(const uint8_t *const packets[], uint8_t universes, uint16_t slotCount, uint8_t *samples);
+size_t dmxParallelEncodeFrameScalar(const uint8_t *const packets[], uint8_t universes, uint16_t slotCount, uint8_t *samples);
+
+#endif
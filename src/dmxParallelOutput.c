@@ -0,0 +1,394 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmx4esp.h"
+
+#if DMX_PARALLEL_SUPPORTED
+
+#include "dmxFrame.h"
+#include "dmxParallel.h"
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_io.h"
+#include "sdkconfig.h"
+
+#define DMX_PARALLEL_NOTIFY_FRAME (1 << 0)
+#define DMX_PARALLEL_NOTIFY_DONE (1 << 1)
+
+/**
+ * @brief State of the bit-parallel output: up to 16 universes sharing one LCD / I2S DMA stream.
+ */
+struct dmxParallelInstance {
+    uint8_t universes;
+    dmxTxFrame frames[DMX_PARALLEL_MAX_UNIVERSES]; //shared send frames, producers write them lock-free
+    uint8_t packets[DMX_PARALLEL_MAX_UNIVERSES][513]; //snapshots of the frames, [0] start code
+    uint32_t sentChangeSeq[DMX_PARALLEL_MAX_UNIVERSES];
+
+    //double buffered samples: the DMA streams one buffer while the next frame is encoded into the other
+    uint8_t *samples[2];
+    size_t frameBytes;
+    uint8_t backSamples;
+    volatile bool dmaBusy;
+
+    esp_lcd_i80_bus_handle_t bus;
+    esp_lcd_panel_io_handle_t io;
+    esp_timer_handle_t frameTimer;
+    TaskHandle_t task;
+
+    uint16_t slotCount;
+    uint32_t framePeriodUs; //never below the length of the sample stream
+    uint32_t pending; //notification bits received but not consumed yet, only used by the output task
+    dmxRefreshStats refresh; //only written by the output task
+    int64_t lastFrameStart;
+    uint32_t avgIntervalUs;
+};
+
+/**
+ * @brief Internal DMA callback, called from interrupt context once a frame left the bus.
+ *
+ * @note This function is only expected to be used internally.
+ * @note Wakes the output task in case a deadline found the frame still on the bus.
+ * @return true if a higher priority task was woken.
+ */
+static bool IRAM_ATTR dmxParallelDoneCallback(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *event, void *context){
+    dmx_parallel_handle_t dmx = context;
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    dmx->dmaBusy = false;
+    xTaskNotifyFromISR(dmx->task, DMX_PARALLEL_NOTIFY_DONE, eSetBits, &higherPriorityTaskWoken);
+    return higherPriorityTaskWoken == pdTRUE;
+}
+
+/**
+ * @brief Internal timer callback, wakes the output task on every frame deadline.
+ *
+ * @note This function is only expected to be used internally.
+ * @param parameters The parallel output.
+ *
+ * @return void
+ */
+static void IRAM_ATTR dmxParallelTimerCallback(void *parameters){
+    dmx_parallel_handle_t dmx = parameters;
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    xTaskNotifyFromISR(dmx->task, DMX_PARALLEL_NOTIFY_FRAME, eSetBits, &higherPriorityTaskWoken);
+    if(higherPriorityTaskWoken == pdTRUE){
+        esp_timer_isr_dispatch_need_yield();
+    }
+#else
+    xTaskNotify(dmx->task, DMX_PARALLEL_NOTIFY_FRAME, eSetBits);
+#endif
+}
+
+/**
+ * @brief Internal function to block the output task until one of the given notification bits is set.
+ *
+ * @note This function is only expected to be used internally.
+ * @param dmx The parallel output.
+ * @param bits Notification bits to wait for, they're consumed on return.
+ *
+ * @return void
+ */
+static void waitForParallelNotification(dmx_parallel_handle_t dmx, uint32_t bits){
+    while((dmx->pending & bits) == 0){
+        uint32_t value = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &value, portMAX_DELAY);
+        dmx->pending |= value;
+    }
+    dmx->pending &= ~bits;
+}
+
+/**
+ * @brief Internal function to snapshot all universes and encode them into the back sample buffer.
+ *
+ * @note This function is only expected to be used internally.
+ * @note The CPU cycles of snapshot + transpose are tracked per frame.
+ * @param dmx The parallel output.
+ *
+ * @return void
+ */
+static void encodeFrame(dmx_parallel_handle_t dmx){
+    const uint8_t *packets[DMX_PARALLEL_MAX_UNIVERSES];
+    esp_cpu_cycle_count_t startCycles = esp_cpu_get_cycle_count();
+
+    for(int universe = 0; universe < dmx->universes; universe++){
+        //a torn snapshot keeps the previous data of this universe
+        dmxTxFrameSnapshot(&dmx->frames[universe], &dmx->packets[universe][1], &dmx->sentChangeSeq[universe]);
+        packets[universe] = dmx->packets[universe];
+    }
+    dmxParallelEncodeFrame(packets, dmx->universes, dmx->slotCount, dmx->samples[dmx->backSamples]);
+
+    uint32_t cycles = esp_cpu_get_cycle_count() - startCycles;
+    dmx->refresh.avgFrameCycles = dmx->refresh.avgFrameCycles == 0 ? cycles : dmx->refresh.avgFrameCycles + ((int32_t) (cycles - dmx->refresh.avgFrameCycles)) / 16;
+}
+
+/**
+ * @brief Internal loop, starts one bit-parallel frame per timer deadline.
+ *
+ * @note This function is only expected to be used internally.
+ * @note If the previous frame is still on the bus (at the top rate the deadline and the end of the stream coincide),
+ *       the next one is encoded meanwhile and starts right after it. The deadlines are re-anchored on that frame.
+ * @param parameters The parallel output.
+ *
+ * @return void
+ */
+static void dmxParallelTask(void *parameters){
+    dmx_parallel_handle_t dmx = parameters;
+
+    for(;;){
+        waitForParallelNotification(dmx, DMX_PARALLEL_NOTIFY_FRAME);
+        encodeFrame(dmx); //into the buffer the DMA doesn't stream, so it's ready once the bus is free
+
+        bool late = false;
+        while(dmx->dmaBusy){
+            waitForParallelNotification(dmx, DMX_PARALLEL_NOTIFY_DONE); //a stale bit of an earlier frame only costs a loop
+            late = true;
+        }
+
+        int64_t frameStart = esp_timer_get_time();
+        if(dmx->lastFrameStart != 0){
+            uint32_t interval = (uint32_t) (frameStart - dmx->lastFrameStart);
+            uint32_t period = dmx->framePeriodUs;
+            uint32_t jitter = interval > period ? interval - period : period - interval;
+
+            dmx->avgIntervalUs = dmx->avgIntervalUs == 0 ? interval : dmx->avgIntervalUs + ((int32_t) (interval - dmx->avgIntervalUs)) / 16;
+            dmx->refresh.avgJitterUs += ((int32_t) (jitter - dmx->refresh.avgJitterUs)) / 16;
+            if(jitter > dmx->refresh.maxJitterUs){
+                dmx->refresh.maxJitterUs = jitter;
+            }
+        }
+        dmx->lastFrameStart = frameStart;
+        dmx->refresh.framesSent++;
+
+        dmx->dmaBusy = true;
+        if(esp_lcd_panel_io_tx_color(dmx->io, -1, dmx->samples[dmx->backSamples], dmx->frameBytes) != ESP_OK){
+            dmx->dmaBusy = false;
+        }
+        dmx->backSamples ^= 1; //the other buffer is free again once this frame is done
+
+        if(late){
+            esp_timer_stop(dmx->frameTimer); //next deadline one period after this frame
+            esp_timer_start_periodic(dmx->frameTimer, dmx->framePeriodUs);
+            dmx->pending &= ~DMX_PARALLEL_NOTIFY_FRAME; //a deadline that passed while this frame waited is served by it
+        }
+    }
+}
+
+/**
+ * @brief Creates a bit-parallel output sending up to 16 universes from one DMA stream, one GPIO per universe.
+ *
+ * @note  Uses the LCD peripheral (esp32-s3) or I2S in parallel mode (esp32). Break, mark after break,
+ *        start / stop bits and slots of all universes are encoded into the sample stream, all universes
+ *        share the slot count and timing (104µs break, 16µs mark after break).
+ * @param config Pins, number of universes and refresh rate.
+ * @param handle Pointer to the handle of the created output.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxParallelCreate(const dmxParallelConfig *config, dmx_parallel_handle_t *handle){
+    if(config->universes < 1 || config->universes > DMX_PARALLEL_MAX_UNIVERSES){
+        printf("Number of universes out of scope (1 - %i): %i\n", DMX_PARALLEL_MAX_UNIVERSES, config->universes);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(config->slotCount != 0 && (config->slotCount < DMX_MIN_SLOTS || config->slotCount > DMX_MAX_SLOTS)){
+        printf("Slot count out of scope (%i - %i): %i\n", DMX_MIN_SLOTS, DMX_MAX_SLOTS, config->slotCount);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(config->clockPin == GPIO_NUM_NC){
+        printf("No clock pin present, the bus needs a (unused) clock output\n");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dmx_parallel_handle_t dmx = heap_caps_calloc(1, sizeof(struct dmxParallelInstance), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if(dmx == NULL){
+        printf("Memory allocation failed");
+        return ESP_ERR_NO_MEM;
+    }
+
+    dmx->universes = config->universes;
+    dmx->slotCount = config->slotCount != 0 ? config->slotCount : DMX_MAX_SLOTS;
+    dmx->framePeriodUs = dmxFramePeriodUs(config->refreshRate != 0 ? config->refreshRate : DMX_DEFAULT_REFRESH_RATE, dmx->slotCount,
+                                          DMX_PARALLEL_BREAK_SAMPLES * DMX_PARALLEL_BIT_US, DMX_PARALLEL_MARK_SAMPLES * DMX_PARALLEL_BIT_US);
+    if(dmx->framePeriodUs < dmxParallelFrameUs(dmx->slotCount)){
+        dmx->framePeriodUs = dmxParallelFrameUs(dmx->slotCount); //the trailing mark is part of every stream
+    }
+    for(int universe = 0; universe < DMX_PARALLEL_MAX_UNIVERSES; universe++){
+        dmxTxFrameInit(&dmx->frames[universe]);
+    }
+
+    size_t sampleBytes = dmxParallelSampleBytes(dmx->universes);
+    dmx->frameBytes = dmxParallelFrameSamples(dmx->slotCount) * sampleBytes;
+    for(int i = 0; i < 2; i++){
+        dmx->samples[i] = heap_caps_malloc(dmx->frameBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        if(dmx->samples[i] == NULL){
+            printf("Memory allocation failed");
+            dmxParallelDelete(dmx);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    //lanes without a universe idle high, they only need a pin if the driver insists on a full bus
+    esp_lcd_i80_bus_config_t busConfig = {
+        .dc_gpio_num = -1,
+        .wr_gpio_num = config->clockPin,
+        .clk_src = LCD_CLK_SRC_DEFAULT,
+        .bus_width = sampleBytes * 8,
+        .max_transfer_bytes = dmx->frameBytes,
+        .sram_trans_align = 4
+    };
+    for(size_t lane = 0; lane < sampleBytes * 8; lane++){
+        busConfig.data_gpio_nums[lane] = config->pins[lane];
+    }
+
+    esp_err_t result = esp_lcd_new_i80_bus(&busConfig, &dmx->bus);
+    if(result == ESP_OK){
+        const esp_lcd_panel_io_i80_config_t ioConfig = {
+            .cs_gpio_num = -1,
+            .pclk_hz = 1000000 / DMX_PARALLEL_BIT_US * DMX_PARALLEL_OVERSAMPLE, //250 kbaud
+            .trans_queue_depth = 2,
+            .on_color_trans_done = dmxParallelDoneCallback,
+            .user_ctx = dmx,
+            .lcd_cmd_bits = 0,
+            .lcd_param_bits = 0
+        };
+        result = esp_lcd_new_panel_io_i80(dmx->bus, &ioConfig, &dmx->io);
+    }
+    if(result != ESP_OK){
+        printf("Failed to set up the parallel DMX bus: %d\n", result);
+        dmxParallelDelete(dmx);
+        return result;
+    }
+
+    if(config->dir != GPIO_NUM_NC){
+        gpio_set_direction(config->dir, GPIO_MODE_OUTPUT);
+        gpio_set_level(config->dir, 1); // PULL OUTPUT DIR HIGH TO SEND
+    }
+
+    if(xTaskCreatePinnedToCore(dmxParallelTask, "DMX Parallel Task", 2048, dmx, 1, &dmx->task, 1) != pdPASS){ //PIN TO CORE 1
+        printf("Failed to create the DMX parallel task\n");
+        dmx->task = NULL;
+        dmxParallelDelete(dmx);
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_timer_create_args_t timerArgs = {
+        .callback = dmxParallelTimerCallback,
+        .arg = dmx,
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+        .dispatch_method = ESP_TIMER_ISR,
+#else
+        .dispatch_method = ESP_TIMER_TASK,
+#endif
+        .name = "dmx parallel",
+        .skip_unhandled_events = true
+    };
+    result = esp_timer_create(&timerArgs, &dmx->frameTimer);
+    if(result == ESP_OK){
+        result = esp_timer_start_periodic(dmx->frameTimer, dmx->framePeriodUs);
+    }
+    if(result != ESP_OK){
+        printf("Failed to create DMX timer: %d\n", result);
+        dmxParallelDelete(dmx);
+        return result;
+    }
+
+    *handle = dmx;
+    return ESP_OK;
+}
+
+/**
+ * @brief Stops a bit-parallel output and frees its memory.
+ *
+ * @param handle The output to delete, the handle is invalid afterwards.
+ * @return ESP_OK on success
+ */
+esp_err_t dmxParallelDelete(dmx_parallel_handle_t handle){
+    if(handle == NULL){
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if(handle->frameTimer != NULL){
+        esp_timer_stop(handle->frameTimer);
+        esp_timer_delete(handle->frameTimer);
+    }
+    if(handle->task != NULL){
+        vTaskDelete(handle->task);
+    }
+    if(handle->io != NULL){
+        esp_lcd_panel_io_del(handle->io); //waits for a running frame
+    }
+    if(handle->bus != NULL){
+        esp_lcd_del_i80_bus(handle->bus);
+    }
+    for(int i = 0; i < 2; i++){
+        heap_caps_free(handle->samples[i]);
+    }
+
+    heap_caps_free(handle);
+    return ESP_OK;
+}
+
+/**
+ * @brief Sets the dmx data of one universe of a bit-parallel output.
+ *
+ * @note  The whole frame becomes visible at once with the next frame.
+ *        Concurrent calls for the same universe have to be serialized by the caller.
+ * @param handle The parallel output.
+ * @param universe Index of the universe (0 - universes-1)
+ * @param data 512 bytes long array containing the dmx data to send
+ * @return void
+ */
+void dmxParallelWrite(dmx_parallel_handle_t handle, uint8_t universe, const uint8_t data[]){
+    if(universe >= handle->universes){
+        printf("Universe out of scope (0 - %i): %i", handle->universes - 1, universe);
+        return;
+    }
+
+    dmxTxFrameBeginBulk(&handle->frames[universe]);
+    dmxTxFrameWriteBulk(&handle->frames[universe], 0, data, DMX_MAX_SLOTS);
+    dmxTxFrameEndBulk(&handle->frames[universe]);
+}
+
+/**
+ * @brief Changes the value of one dmx channel of one universe of a bit-parallel output.
+ *
+ * @note  Lock-free, safe to call at high rates from any number of tasks.
+ * @param handle The parallel output.
+ * @param universe Index of the universe (0 - universes-1)
+ * @param address The address of the dmx channel (1 - 512)
+ * @param value The dmx value to send (0 - 255)
+ * @return void
+ */
+void dmxParallelWriteAddress(dmx_parallel_handle_t handle, uint8_t universe, uint16_t address, uint8_t value){
+    if(universe >= handle->universes || address < 1 || address > 512){
+        printf("Universe (0 - %i) / address (1 - 512) out of scope: %i, %i", handle->universes - 1, universe, address);
+        return;
+    }
+
+    dmxTxFrameSetSlot(&handle->frames[universe], address - 1, value);
+}
+
+/**
+ * @brief Returns the target and achieved refresh rate of a bit-parallel output.
+ *
+ * @note  avgFrameCycles covers snapshot + transpose of all universes.
+ * @param handle The parallel output.
+ * @param stats Pointer to the struct to fill.
+ * @return void
+ */
+void dmxParallelGetStats(dmx_parallel_handle_t handle, dmxRefreshStats *stats){
+    uint32_t avgInterval = handle->avgIntervalUs;
+
+    *stats = handle->refresh;
+    stats->targetRate = 1000000.0f / handle->framePeriodUs;
+    stats->achievedRate = avgInterval > 0 ? 1000000.0f / avgInterval : 0.0f;
+}
+
+#endif
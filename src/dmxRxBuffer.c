@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "dmxRxBuffer.h"
+#include <string.h>
+
+/**
+ * @brief Clears all frames, frame 0 is the (empty) latest frame until the first one is published.
+ *
+ * @param buffer Pointer to the buffer to initialize.
+ * @return void
+ */
+void dmxRxBufferInit(dmxRxBuffer *buffer){
+    memset(buffer, 0, sizeof(*buffer));
+    for(int i = 0; i < DMX_RX_BUFFERS; i++){
+        atomic_init(&buffer->frames[i].readers, 0);
+    }
+    atomic_init(&buffer->latest, 0);
+    buffer->writing = 1;
+}
+
+/**
+ * @brief Returns the packet the decoder writes the next frame into.
+ *
+ * @param buffer The receive buffer.
+ * @return packet of 513 bytes
+ */
+uint8_t* dmxRxBufferWritePacket(dmxRxBuffer *buffer){
+    return buffer->writing < DMX_RX_BUFFERS ? buffer->frames[buffer->writing].packet : buffer->scratch;
+}
+
+/**
+ * @brief Publishes the frame in the write packet and returns the packet for the next frame.
+ *
+ * @note Writer side only (the decoder). Slots beyond length are cleared.
+ *       The channels that differ from the previous frame are recorded in frame->changes.
+ *       If readers hold every frame but the latest, the next frame is decoded into a scratch
+ *       packet and dropped.
+ * @param buffer The receive buffer.
+ * @param length Bytes received, start code included (1 - 513)
+ * @param timestamp Time the frame was complete (µs)
+ * @return packet for the next frame
+ */
+uint8_t* dmxRxBufferPublish(dmxRxBuffer *buffer, uint16_t length, int64_t timestamp){
+    unsigned int previous = atomic_load_explicit(&buffer->latest, memory_order_relaxed);
+
+    if(buffer->writing < DMX_RX_BUFFERS){
+        dmxRxFrame *frame = &buffer->frames[buffer->writing];
+        if(length < 513){
+            memset(&frame->packet[length], 0, 513 - length);
+        }
+
+        //the previous frame is only written by us, it can't change while it's compared
+        const dmxRxFrame *latestFrame = &buffer->frames[previous];
+        if(latestFrame->sequence == 0){
+            dmxDiffMarkAll(&frame->changes, 513);
+        } else{
+            dmxDiffPackets(frame->packet, latestFrame->packet, length > latestFrame->length ? length : latestFrame->length, &frame->changes);
+        }
+
+        frame->length = length;
+        frame->sequence = ++buffer->sequence;
+        frame->timestamp = timestamp;
+        atomic_store_explicit(&buffer->latest, buffer->writing, memory_order_seq_cst);
+    } else{
+        buffer->dropped++;
+    }
+
+    //only frames that aren't the latest (anymore) are candidates. a reader references a frame before
+    //checking latest again, so once latest is switched (seq_cst on both sides) either the reader backs off
+    //or its reference is visible here. the previous latest frame is reused last, unreferenced pointers to it stay valid longer
+    unsigned int latest = atomic_load_explicit(&buffer->latest, memory_order_relaxed);
+    int next = DMX_RX_BUFFERS;
+    for(int i = 0; i < DMX_RX_BUFFERS; i++){
+        if(i == (int) latest || atomic_load_explicit(&buffer->frames[i].readers, memory_order_seq_cst) != 0){
+            continue;
+        }
+        if(next == DMX_RX_BUFFERS || next == (int) previous){
+            next = i;
+        }
+    }
+
+    buffer->writing = next;
+    return dmxRxBufferWritePacket(buffer);
+}
+
+/**
+ * @brief Takes a reference on the latest complete frame, it stays unchanged until released.
+ *
+ * @note Never blocks and never copies. Every acquire needs a dmxRxBufferRelease().
+ * @param buffer The receive buffer.
+ * @return the latest frame (sequence 0 if nothing was received yet)
+ */
+const dmxRxFrame* dmxRxBufferAcquire(dmxRxBuffer *buffer){
+    for(;;){
+        unsigned int latest = atomic_load_explicit(&buffer->latest, memory_order_acquire);
+        dmxRxFrame *frame = &buffer->frames[latest];
+
+        atomic_fetch_add_explicit(&frame->readers, 1, memory_order_seq_cst);
+        if(atomic_load_explicit(&buffer->latest, memory_order_seq_cst) == latest){
+            return frame; //still the latest, the writer won't pick it while we hold it
+        }
+        atomic_fetch_sub_explicit(&frame->readers, 1, memory_order_release); //a newer frame was published meanwhile
+    }
+}
+
+/**
+ * @brief Releases a frame taken with dmxRxBufferAcquire().
+ *
+ * @param buffer The receive buffer.
+ * @param frame The frame to release.
+ * @return void
+ */
+void dmxRxBufferRelease(dmxRxBuffer *buffer, const dmxRxFrame *frame){
+    atomic_fetch_sub_explicit(&((dmxRxFrame*) frame)->readers, 1, memory_order_release);
+}
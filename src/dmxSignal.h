@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_SIGNAL_H
+#define DMX_SIGNAL_H
+
+#include <stdint.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+
+#define DMX_DEFAULT_LOSS_TIMEOUT_MS 1000 // no valid frame for this long -> signal lost
+
+// what receivers see once the signal is lost
+// DMX_LOSS_HOLD: the last frame stays (default)
+// DMX_LOSS_FADE: the last frame is held for holdMs, then faded to zero over fadeMs
+// DMX_LOSS_BLACKOUT: a frame of zeros is published immediately
+typedef enum {DMX_LOSS_HOLD, DMX_LOSS_FADE, DMX_LOSS_BLACKOUT} dmxLossPolicy;
+
+// DMX_SIGNAL_NONE: nothing received yet
+typedef enum {DMX_SIGNAL_NONE, DMX_SIGNAL_PRESENT, DMX_SIGNAL_LOST} dmxSignalState;
+
+// events returned by dmxSignalTick()
+#define DMX_SIGNAL_EVENT_LOST (1 << 0)
+#define DMX_SIGNAL_EVENT_RESTORED (1 << 1)
+#define DMX_SIGNAL_EVENT_OUTPUT (1 << 2) // publish the held frame scaled to level
+
+/**
+ * @brief Loss-of-signal state of one receiver, fed with valid frames and periodic ticks.
+ */
+typedef struct dmxSignalMonitor {
+    dmxLossPolicy policy;
+    int64_t timeoutUs; // 64 bit, any uint32_t ms value fits
+    int64_t holdUs;
+    int64_t fadeUs;
+    dmxSignalState state;
+    int64_t lastFrameUs; // time of the last valid frame, 0 before the first one
+    int64_t lostUs; // time the loss was detected
+    uint8_t level; // 255: held frame, 0: blackout. level of the last output
+    uint32_t losses;
+} dmxSignalMonitor;
+
+void dmxSignalInit(dmxSignalMonitor *monitor, dmxLossPolicy policy, uint32_t timeoutMs, uint32_t holdMs, uint32_t fadeMs);
+
+void dmxSignalFrame(dmxSignalMonitor *monitor, int64_t now);
+uint32_t dmxSignalTick(dmxSignalMonitor *monitor, int64_t now);
+
+void dmxSignalScale(const uint8_t *packet, uint8_t *output, uint16_t length, uint8_t level);
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_START_CODE_H
+#define DMX_START_CODE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+
+// alternate start codes (ANSI E1.11 Annex D)
+#define DMX_START_CODE_NULL 0x00
+#define DMX_START_CODE_TEXT 0x17
+#define DMX_START_CODE_TEST 0x55
+#define DMX_START_CODE_RDM 0xCC
+#define DMX_START_CODE_SIP 0xCF
+
+#define DMX_SIP_LENGTH 25 // start code, 23 data slots, checksum
+#define DMX_TEST_SLOT_VALUE 0x55
+
+/**
+ * @brief Text packet (0x17): one page of ASCII text.
+ */
+typedef struct dmxTextPacket {
+    uint8_t page;
+    uint8_t charactersPerLine; // 0: no line breaks
+    const char *text; // points into the packet, not null terminated
+    uint16_t textLength; // characters up to the first null or the end of the frame
+} dmxTextPacket;
+
+/**
+ * @brief System Information Packet (0xCF), describes the preceding null start code packet.
+ */
+typedef struct dmxSipPacket {
+    uint8_t byteCount; // bytes before the checksum, start code included
+    uint8_t controlFlags;
+    uint16_t previousChecksum; // 16 bit additive checksum of the previous null start code packet
+    uint8_t sequence;
+    uint8_t universe;
+    uint8_t processingLevel;
+    uint8_t softwareVersion;
+    uint16_t packetLength; // of the null start code packet
+    uint16_t packetsSinceSip;
+    uint16_t manufacturers[5]; // ESTA manufacturer IDs of the devices the data passed, 0: none
+} dmxSipPacket;
+
+bool dmxParseText(const uint8_t *packet, uint16_t length, dmxTextPacket *text);
+bool dmxParseSip(const uint8_t *packet, uint16_t length, dmxSipPacket *sip);
+bool dmxIsTestPacket(const uint8_t *packet, uint16_t length);
+
+uint16_t dmxPacketChecksum(const uint8_t *packet, uint16_t length);
+
+#endif
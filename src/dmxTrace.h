@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2024-2025 Nicolas Pfeifer <info@nicodenetworks.com>
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef DMX_TRACE_H
+#define DMX_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+//this module is platform independent (no ESP-IDF / FreeRTOS calls) so it can be tested on a host
+//the caller passes the timestamps (CPU cycles on the esp32)
+
+// trace points in the send task and the receive interrupt, compiled out completely unless set to 1
+// (e.g. target_compile_definitions(${COMPONENT_LIB} PUBLIC DMX_TRACE_ENABLED=1))
+#ifndef DMX_TRACE_ENABLED
+#define DMX_TRACE_ENABLED 0
+#endif
+
+#define DMX_TRACE_ENTRIES 512 // per instance, power of two
+
+// the time between two consecutive events is the latency of the stage in between
+typedef enum {
+    DMX_TRACE_TX_SLEEP, // send task waits for the next deadline / change
+    DMX_TRACE_TX_WAKE, // send task woke up (arg: notification bits)
+    DMX_TRACE_TX_DRAINED, // previous frame left the UART, the next break may start
+    DMX_TRACE_TX_OVERRUN, // deadline skipped, previous frame still on the wire
+    DMX_TRACE_TX_SNAPSHOT, // latest data copied into the back buffer (arg: 1 if it changed)
+    DMX_TRACE_TX_BREAK, // break started
+    DMX_TRACE_TX_MAB, // break ended, mark after break started
+    DMX_TRACE_TX_WRITE, // mark after break ended, start code & slots handed to the UART (arg: start code)
+    DMX_TRACE_TX_WRITTEN, // write returned (arg: bytes)
+    DMX_TRACE_RX_ENTER, // UART interrupt entered
+    DMX_TRACE_RX_BREAK, // break detected
+    DMX_TRACE_RX_BYTES, // FIFO drained into the decoder (arg: bytes)
+    DMX_TRACE_RX_ERROR, // framing / parity / overflow error (arg: interrupt status)
+    DMX_TRACE_RX_PUBLISH, // frame published, subscribers notified (arg: bytes)
+    DMX_TRACE_RX_EXIT, // UART interrupt left
+    DMX_TRACE_EVENT_COUNT
+} dmxTraceEvent;
+
+typedef struct dmxTraceEntry {
+    uint32_t cycles; // timestamp, wraps around
+    uint16_t arg;
+    uint8_t event; // dmxTraceEvent
+    uint8_t reserved;
+} dmxTraceEntry;
+
+/**
+ * @brief Ring of the last DMX_TRACE_ENTRIES events of one instance, one writer, readers never block it.
+ */
+typedef struct dmxTraceRing {
+    atomic_uint head; // events recorded so far, the next one goes to head % DMX_TRACE_ENTRIES
+    dmxTraceEntry entries[DMX_TRACE_ENTRIES];
+} dmxTraceRing;
+
+/**
+ * @brief Records an event, overwriting the oldest one. Only one context may record into a ring.
+ *
+ * @param ring The ring.
+ * @param cycles Timestamp of the event.
+ * @param event The event.
+ * @param arg Event specific value.
+ * @return void
+ */
+static inline void dmxTraceRecord(dmxTraceRing *ring, uint32_t cycles, dmxTraceEvent event, uint16_t arg){
+    unsigned head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    dmxTraceEntry *entry = &ring->entries[head & (DMX_TRACE_ENTRIES - 1)];
+    entry->cycles = cycles;
+    entry->arg = arg;
+    entry->event = event;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+
+void dmxTraceInit(dmxTraceRing *ring);
+size_t dmxTraceRead(dmxTraceRing *ring, dmxTraceEntry *entries, size_t max);
+const char* dmxTraceEventName(uint8_t event);
+
+#endif